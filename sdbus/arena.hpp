@@ -0,0 +1,43 @@
+#ifndef sdbus_ARENA_HPP_
+#define sdbus_ARENA_HPP_
+
+#include <sdbus/read.hpp>
+
+#include <memory_resource>
+
+namespace sdbus
+{
+
+/*
+ * Monotonic arena for the objects decoded from one message. Allocations
+ * are served from an inline buffer, then from chunks taken from the
+ * upstream resource, and are all released at once with the arena.
+ */
+template <size_t N = 1024>
+struct arena : std::pmr::monotonic_buffer_resource
+{
+    explicit arena(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+        std::pmr::monotonic_buffer_resource(_buffer, N, upstream)
+    {}
+
+    template <typename T>
+    T make()
+    {
+        return std::make_obj_using_allocator<T>(std::pmr::polymorphic_allocator<>(this));
+    }
+
+  private:
+    alignas(std::max_align_t) std::byte _buffer[N];
+};
+
+template <size_t N>
+static errc read(sd_bus_message* msg, arena<N>& mem, auto& v)
+{
+    context<error_policy::fail_fast> ctx(msg);
+    ctx.set_resource(&mem);
+    return read(ctx, v);
+}
+
+} // namespace sdbus
+
+#endif // sdbus_ARENA_HPP_
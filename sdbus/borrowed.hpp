@@ -0,0 +1,62 @@
+#ifndef sdbus_BORROWED_HPP_
+#define sdbus_BORROWED_HPP_
+
+#include <sdbus/message.hpp>
+
+namespace sdbus
+{
+
+/*
+ * A view pointing straight into a message buffer (std::string_view,
+ * std::span<const T>, containers of those) together with a reference
+ * to the message that owns the data, so the view stays valid for as
+ * long as the wrapper lives.
+ */
+template <typename T>
+struct borrowed
+{
+    using view_type = T;
+
+    constexpr const T& operator*() const noexcept
+    {
+        return view;
+    }
+
+    constexpr const T* operator->() const noexcept
+    {
+        return &view;
+    }
+
+    constexpr operator const T&() const noexcept
+    {
+        return view;
+    }
+
+    T view{};
+    message owner;
+};
+
+template <typename T>
+struct default_traits<borrowed<T>>
+{
+    static constexpr auto sig = traits<T>::sig;
+
+    static errc read_value(subctx& ctx, borrowed<T>& v)
+    {
+        auto ec = read(ctx, v.view);
+        if (no_error(ec))
+        {
+            v.owner = message(ctx.msg());
+        }
+        return ec;
+    }
+
+    static errc write_value(subctx& ctx, const borrowed<T>& v)
+    {
+        return write(ctx, v.view);
+    }
+};
+
+} // namespace sdbus
+
+#endif // sdbus_BORROWED_HPP_
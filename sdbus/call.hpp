@@ -0,0 +1,200 @@
+#ifndef sdbus_CALL_HPP_
+#define sdbus_CALL_HPP_
+
+#include <sdbus/message.hpp>
+
+#include <algorithm>
+#include <string_view>
+
+namespace sdbus
+{
+
+static constexpr bool is_name_char(char c, bool first)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_' ||
+           (!first && c >= '0' && c <= '9');
+}
+
+/*
+ * Member name: a non-empty identifier not starting with a digit.
+ */
+static constexpr bool valid_member_name(std::string_view s)
+{
+    if (s.empty() || s.size() > 255)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < s.size(); ++i)
+    {
+        if (!is_name_char(s[i], i == 0))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Interface name: two or more member names joined by dots.
+ */
+static constexpr bool valid_interface_name(std::string_view s)
+{
+    if (s.size() > 255)
+    {
+        return false;
+    }
+
+    size_t elements = 0;
+    for (size_t pos = 0; pos <= s.size(); ++elements)
+    {
+        auto end = std::min(s.find('.', pos), s.size());
+        if (!valid_member_name(s.substr(pos, end - pos)))
+        {
+            return false;
+        }
+        pos = end + 1;
+    }
+    return elements > 1;
+}
+
+/*
+ * Bus name: a unique name (":1.42") or a well-known one, which follows the
+ * interface name rules but also allows '-'; empty means no destination.
+ */
+static constexpr bool valid_bus_name(std::string_view s)
+{
+    if (s.empty())
+    {
+        return true;
+    }
+    if (s.size() > 255)
+    {
+        return false;
+    }
+
+    bool unique = s[0] == ':';
+    if (unique)
+    {
+        s.remove_prefix(1);
+    }
+
+    size_t elements = 0;
+    for (size_t pos = 0; pos <= s.size(); ++elements)
+    {
+        auto end = std::min(s.find('.', pos), s.size());
+        if (end == pos)
+        {
+            return false;
+        }
+        for (size_t i = pos; i < end; ++i)
+        {
+            if (!is_name_char(s[i], !unique && i == pos) && s[i] != '-')
+            {
+                return false;
+            }
+        }
+        pos = end + 1;
+    }
+    return elements > 1;
+}
+
+/*
+ * Object path: "/" or '/'-separated non-empty elements of [A-Za-z0-9_].
+ */
+static constexpr bool valid_object_path(std::string_view s)
+{
+    if (s.empty() || s[0] != '/')
+    {
+        return false;
+    }
+    if (s.size() == 1)
+    {
+        return true;
+    }
+
+    for (size_t pos = 1; pos <= s.size();)
+    {
+        auto end = std::min(s.find('/', pos), s.size());
+        if (end == pos)
+        {
+            return false;
+        }
+        for (size_t i = pos; i < end; ++i)
+        {
+            if (!is_name_char(s[i], false))
+            {
+                return false;
+            }
+        }
+        pos = end + 1;
+    }
+    return true;
+}
+
+/*
+ * A method call whose header fields and argument types are fixed at
+ * compile time. The fields are validated once, when the template is
+ * instantiated, and each create() only has sd-bus build the header from
+ * the constant strings and appends the arguments in one batch.
+ */
+template <sig_string Service, sig_string Path, sig_string Interface, sig_string Member,
+          typename... Args>
+struct prepared_call
+{
+    static_assert(valid_bus_name(Service), "Invalid bus name.");
+    static_assert(valid_object_path(Path), "Invalid object path.");
+    static_assert(valid_interface_name(Interface), "Invalid interface name.");
+    static_assert(valid_member_name(Member), "Invalid member name.");
+
+    static constexpr auto sig = arg_list<Args...>::sig;
+
+    static constexpr const char* destination = Service.empty() ? nullptr : Service.c_str();
+
+    static message create(sd_bus* bus, const Args&... args)
+    {
+        sd_bus_message* m;
+        auto ret = sd_bus_message_new_method_call(bus, &m, destination, Path.c_str(),
+                                                  Interface.c_str(), Member.c_str());
+        if (ret < 0)
+        {
+            throw std::system_error(std::error_code(-ret, std::system_category()));
+        }
+
+        message msg(message::move_tag{}, m);
+        msg.append_all(args...);
+        return msg;
+    }
+};
+
+/*
+ * A signal whose header fields and argument types are fixed at compile
+ * time, see prepared_call.
+ */
+template <sig_string Path, sig_string Interface, sig_string Member, typename... Args>
+struct prepared_signal
+{
+    static_assert(valid_object_path(Path), "Invalid object path.");
+    static_assert(valid_interface_name(Interface), "Invalid interface name.");
+    static_assert(valid_member_name(Member), "Invalid member name.");
+
+    static constexpr auto sig = arg_list<Args...>::sig;
+
+    static message create(sd_bus* bus, const Args&... args)
+    {
+        sd_bus_message* m;
+        auto ret =
+            sd_bus_message_new_signal(bus, &m, Path.c_str(), Interface.c_str(), Member.c_str());
+        if (ret < 0)
+        {
+            throw std::system_error(std::error_code(-ret, std::system_category()));
+        }
+
+        message msg(message::move_tag{}, m);
+        msg.append_all(args...);
+        return msg;
+    }
+};
+
+} // namespace sdbus
+
+#endif // sdbus_CALL_HPP_
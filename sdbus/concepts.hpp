@@ -3,8 +3,12 @@
 
 #include <concepts>
 #include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <span>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <variant>
 
 namespace sdbus::concepts
@@ -17,6 +21,12 @@ concept Basic =
     std::same_as<T, uint16_t> || std::same_as<T, uint32_t> || std::same_as<T, uint64_t> ||
     std::same_as<T, unsigned long long> || std::same_as<T, double>;
 
+template <typename T>
+concept Fixed = Basic<T> && !std::same_as<T, bool>;
+
+template <typename T>
+concept Enum = std::is_scoped_enum_v<T> && Basic<std::underlying_type_t<T>>;
+
 template <typename T>
 concept String = std::convertible_to<T, std::string_view> && std::assignable_from<T&, const char*>;
 
@@ -34,6 +44,46 @@ concept GenericContainer = requires {
 template <typename T>
 concept Container = GenericContainer<T> && !String<T>;
 
+/*
+ * Views and generators: ranges that are not containers and may be single
+ * pass and unsized, written as arrays while they are iterated.
+ */
+template <typename T>
+concept InputRange = std::ranges::input_range<T> && !GenericContainer<T> &&
+                     !std::convertible_to<T, std::string_view>;
+
+/*
+ * Ranges that can only be iterated when non-const, such as filter_view
+ * and std::generator. Writing one advances it.
+ */
+template <typename T>
+concept MutableRange = InputRange<T> && !std::ranges::input_range<const T>;
+
+template <typename T>
+concept Contiguous = Container<T> && std::contiguous_iterator<typename T::iterator>;
+
+template <typename T>
+concept BasicArray = Contiguous<T> && Fixed<typename T::value_type>;
+
+template <typename T>
+concept RandomAccess =
+    Container<T> &&
+    std::derived_from<typename std::iterator_traits<typename T::iterator>::iterator_category,
+                      std::random_access_iterator_tag>;
+
+template <typename T>
+concept BoolArray = RandomAccess<T> && std::same_as<typename T::value_type, bool>;
+
+template <typename T>
+concept BasicView = BasicArray<T> && std::is_const_v<typename T::element_type> &&
+                    T::extent == std::dynamic_extent;
+
+template <typename T>
+concept Resizable = requires(T t) { t.resize(t.size()); };
+
+template <typename T>
+concept Reservable = requires(T t) { t.reserve(t.size()); };
+
 template <typename T>
 concept HasEmplaceBack = requires(T t) {
     { t.emplace(t.end(), std::declval<typename T::value_type>) };
@@ -47,6 +97,47 @@ concept HasEmplace = requires(T t) {
 template <typename T>
 concept Emplaceable = HasEmplaceBack<T> || HasEmplace<T>;
 
+template <typename T>
+concept Sequence = HasEmplaceBack<T> && Resizable<T> && requires(T t) {
+    { t[0] } -> std::same_as<typename T::value_type&>;
+};
+
+template <typename T>
+concept NodeContainer = HasEmplace<T> && requires(T t) { t.extract(t.begin()); };
+
+/*
+ * Containers of fixed-size basic elements; the byte length of an array gives
+ * their exact element count.
+ */
+template <typename T>
+concept FixedContainer = Emplaceable<T> && Fixed<typename T::value_type>;
+
+/*
+ * Sorted vector-backed associative containers: boost::container::flat_*
+ * expose their sequence, std::flat_map its key and mapped containers.
+ */
+template <typename T>
+concept BoostFlat = Container<T> && requires(T t) {
+    t.extract_sequence();
+    t.value_comp();
+};
+
+template <typename T>
+concept StdFlatMap = Container<T> && requires(T t) {
+    typename T::key_container_type;
+    typename T::mapped_container_type;
+    std::move(t).extract();
+    t.value_comp();
+};
+
+template <typename T>
+concept FlatContainer = BoostFlat<T> || StdFlatMap<T>;
+
+template <typename T>
+concept UniqueKeys = requires(T t) {
+    { t.emplace(std::declval<typename T::value_type>()).second } -> std::convertible_to<bool>;
+};
+
 template <typename T>
 concept DictEntry = requires(T t) {
     typename T::first_type;
@@ -54,9 +145,21 @@ concept DictEntry = requires(T t) {
     { t.first } -> std::same_as<typename T::first_type&>;
     { t.second } -> std::same_as<typename T::second_type&>;
     requires Basic<std::decay_t<typename T::first_type>> ||
-                 String<std::decay_t<typename T::first_type>>;
+                 String<std::decay_t<typename T::first_type>> ||
+                 WriteOnlyString<std::decay_t<typename T::first_type>>;
 };
 
+/*
+ * std::tuple and std::pair encode as structs, as do classes declaring their
+ * members: using struct_t = sdbus::members<...>. As array elements, pairs
+ * that are a DictEntry encode as dict entries instead.
+ */
+template <typename T>
+concept Tuple = requires { std::tuple_size<T>::value; } && !std::ranges::range<T>;
+
+template <typename T>
+concept Struct = requires { typename T::struct_t; };
+
 template <typename T>
 concept Variant = requires {
     { std::variant_size<T>::value };
@@ -3,6 +3,94 @@
 namespace sdbus
 {
 
+namespace
+{
+
+struct error_category_impl : std::error_category
+{
+    const char* name() const noexcept override
+    {
+        return "sdbus";
+    }
+
+    std::string message(int ev) const override
+    {
+        switch (static_cast<errc>(ev))
+        {
+        case errc::success:
+            return "Success";
+        case errc::invalid_type:
+            return "Invalid type";
+        case errc::invalid_enum:
+            return "Invalid enum value";
+        case errc::invalid_enum_string:
+            return "Invalid enum string";
+        case errc::invalid_property:
+            return "Invalid property";
+        case errc::unknown_property:
+            return "Unknown property";
+        case errc::read_error:
+            return "Read error";
+        case errc::write_error:
+            return "Write error";
+        case errc::no_memory:
+            return "Out of memory";
+        case errc::out_of_space:
+            return "Out of space";
+        case errc::bad_variant:
+            return "Bad variant";
+        case errc::bad_exception:
+            return "Exception in handler";
+        }
+        return "Unknown error";
+    }
+
+    std::error_condition default_error_condition(int ev) const noexcept override
+    {
+        switch (static_cast<errc>(ev))
+        {
+        case errc::success:
+            return std::error_condition(ev, *this);
+        case errc::invalid_enum:
+        case errc::invalid_enum_string:
+        case errc::invalid_property:
+        case errc::unknown_property:
+        case errc::bad_variant:
+            return {static_cast<int>(condition::non_critical_error), condition_cat()};
+        default:
+            return {static_cast<int>(condition::critical_error), condition_cat()};
+        }
+    }
+};
+
+struct condition_category_impl : std::error_category
+{
+    const char* name() const noexcept override
+    {
+        return "sdbus.condition";
+    }
+
+    std::string message(int ev) const override
+    {
+        switch (static_cast<condition>(ev))
+        {
+        case condition::critical_error:
+            return "Critical error";
+        case condition::non_critical_error:
+            return "Non-critical error";
+        }
+        return "Unknown condition";
+    }
+};
+
+const error_category_impl error_cat_impl;
+const condition_category_impl condition_cat_impl;
+
+} // namespace
+
+const std::error_category& error_cat_ref = error_cat_impl;
+const std::error_category& condition_cat_ref = condition_cat_impl;
+
 static constexpr auto DBUS_MAX_PATH = 256;
 
 static thread_local char path[DBUS_MAX_PATH];
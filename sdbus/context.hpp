@@ -6,6 +6,10 @@
 #include <sdbus/error_code.hpp>
 
 #include <functional>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace sdbus
 {
@@ -39,11 +43,31 @@ struct path_entry
     const char* to_str() const;
 };
 
-struct defctx;
+/*
+ * What an array read loop does with a failed element: return the error, or
+ * pass it to the context's handler, which may drop the element.
+ */
+enum class element_policy
+{
+    fail,
+    handle,
+};
+
+/*
+ * Policy an array read loop is instantiated for, see subctx::with_policy().
+ */
+template <element_policy E, bool TrackPath>
+struct loop_policy
+{
+    static constexpr element_policy on_error = E;
+    static constexpr bool track_path = TrackPath;
+};
+
+struct basic_context;
 struct subctx
 {
     constexpr subctx(const subctx&) = default;
-    constexpr subctx(defctx& ctx) : _context{ctx}
+    constexpr subctx(basic_context& ctx) : _context{ctx}
     {}
     constexpr subctx(size_t index, const subctx& parent) :
         _context{parent._context}, _path{index, parent._path}
@@ -53,6 +77,13 @@ struct subctx
     {}
     constexpr sd_bus_message* msg() const;
     constexpr errc error(errc ec) const;
+    constexpr bool track_path() const;
+    template <typename F>
+    constexpr errc with_policy(F&& f) const;
+    template <typename F>
+    constexpr errc with_path_tracking(F&& f) const;
+    constexpr bool reuse() const;
+    std::pmr::memory_resource* resource() const;
     constexpr const path_entry& path() const
     {
         return _path;
@@ -75,16 +106,21 @@ struct subctx
     }
 
   protected:
-    defctx& _context;
+    basic_context& _context;
     const path_entry _path;
 };
 
-struct defctx : subctx
+/*
+ * Root of a read or write: the message, the handler for element errors
+ * (none fails on the first one) and whether array elements get their own
+ * path entry for reporting.
+ */
+struct basic_context : subctx
 {
-    using error_callback = std::function<errc(const subctx&, errc)>;
+    using error_handler = errc (*)(const basic_context&, const subctx&, errc);
 
-    constexpr defctx(sd_bus_message* msg, error_callback&& error_cb = {}) :
-        subctx{*this}, _msg{msg}, _error(std::move(error_cb))
+    constexpr basic_context(sd_bus_message* msg, bool track_path, error_handler handler = nullptr) :
+        subctx{*this}, _msg{msg}, _handler{handler}, _track_path{track_path}
     {}
     constexpr sd_bus_message* msg() const
     {
@@ -96,19 +132,174 @@ struct defctx : subctx
     }
     constexpr errc error(const subctx& ctx, errc ec) const
     {
-        if (_error)
+        return _handler ? _handler(*this, ctx, ec) : ec;
+    }
+    constexpr bool track_path() const
+    {
+        return _track_path;
+    }
+    /*
+     * Calls f with the loop_policy matching this context. Array read loops
+     * branch here once per container and exist in four variants, so a loop
+     * without a handler makes no handler call per element and one without
+     * path tracking builds no path entry.
+     */
+    template <typename F>
+    constexpr errc with_policy(F&& f) const
+    {
+        if (_handler)
         {
-            return _error(ctx, ec);
+            return _track_path ? f(loop_policy<element_policy::handle, true>{})
+                               : f(loop_policy<element_policy::handle, false>{});
         }
-
-        return ec;
+        return _track_path ? f(loop_policy<element_policy::fail, true>{})
+                           : f(loop_policy<element_policy::fail, false>{});
+    }
+    /*
+     * Calls f with std::bool_constant<track_path()>, for write loops, which
+     * pass element errors up unchanged.
+     */
+    template <typename F>
+    constexpr errc with_path_tracking(F&& f) const
+    {
+        return _track_path ? f(std::true_type{}) : f(std::false_type{});
+    }
+    constexpr bool reuse() const
+    {
+        return _reuse;
+    }
+    /*
+     * In reuse mode reads overwrite the existing contents of the target in
+     * place, keeping its elements and their storage, instead of appending.
+     */
+    constexpr void set_reuse(bool reuse)
+    {
+        _reuse = reuse;
+    }
+    std::pmr::memory_resource* resource() const
+    {
+        return _resource ? _resource : std::pmr::get_default_resource();
+    }
+    /*
+     * Memory resource for allocator-aware (pmr) values created while
+     * reading that have no enclosing container to take an allocator from,
+     * such as variant alternatives.
+     */
+    constexpr void set_resource(std::pmr::memory_resource* resource)
+    {
+        _resource = resource;
     }
 
   private:
     sd_bus_message* _msg;
+    error_handler _handler;
+    bool _track_path;
+    bool _reuse = false;
+    std::pmr::memory_resource* _resource = nullptr;
+};
+
+/*
+ * Context with a run-time error callback, which decides per failed array
+ * element whether to skip it (success) or to abort with an error.
+ */
+struct defctx : basic_context
+{
+    using error_callback = std::function<errc(const subctx&, errc)>;
+
+    constexpr defctx(sd_bus_message* msg, error_callback&& error_cb = {}) :
+        basic_context{msg, true, error_cb ? &call : nullptr},
+        _error(std::move(error_cb))
+    {}
+
+  private:
+    static errc call(const basic_context& ctx, const subctx& sub, errc ec)
+    {
+        return static_cast<const defctx&>(ctx)._error(sub, ec);
+    }
+
     error_callback _error;
 };
 
+enum class error_policy
+{
+    fail_fast,
+    skip,
+    collect,
+};
+
+struct error_entry
+{
+    std::string path;
+    errc ec;
+};
+
+/*
+ * Context with the error policy and path tracking fixed at compile time:
+ * fail_fast aborts on the first error, skip drops failed array elements
+ * and collect drops them while recording each error with its path. With
+ * path tracking off, array elements are read and written in their parent's
+ * context and errors carry the path of the enclosing array. Array loops
+ * see both as a loop_policy, so fail_fast loops neither build a path entry
+ * nor call into a handler.
+ */
+template <error_policy P, bool TrackPath = P == error_policy::collect>
+struct context : basic_context
+{
+    constexpr context(sd_bus_message* msg) : basic_context{msg, TrackPath, handler()}
+    {}
+
+    const std::vector<error_entry>& errors() const
+        requires(P == error_policy::collect)
+    {
+        return _errors;
+    }
+
+  private:
+    static constexpr error_handler handler()
+    {
+        switch (P)
+        {
+        case error_policy::skip:
+            return &drop;
+        case error_policy::collect:
+            return &collect;
+        default:
+            return nullptr;
+        }
+    }
+
+    static errc drop(const basic_context&, const subctx&, errc)
+    {
+        return errc::success;
+    }
+
+    static errc collect(const basic_context& ctx, const subctx& sub, errc ec)
+    {
+        if constexpr (P == error_policy::collect)
+        {
+            try
+            {
+                static_cast<const context&>(ctx)._errors.push_back({sub.path_str(), ec});
+            }
+            catch (...)
+            {
+                return ec;
+            }
+            return errc::success;
+        }
+        else
+        {
+            return ec;
+        }
+    }
+
+    struct empty
+    {};
+
+    [[no_unique_address]] mutable std::conditional_t<P == error_policy::collect,
+                                                     std::vector<error_entry>, empty> _errors;
+};
+
 constexpr sd_bus_message* subctx::msg() const
 {
     return _context.msg();
@@ -119,6 +310,33 @@ constexpr errc subctx::error(errc ec) const
     return _context.error(*this, ec);
 }
 
+constexpr bool subctx::track_path() const
+{
+    return _context.track_path();
+}
+
+template <typename F>
+constexpr errc subctx::with_policy(F&& f) const
+{
+    return _context.with_policy(std::forward<F>(f));
+}
+
+template <typename F>
+constexpr errc subctx::with_path_tracking(F&& f) const
+{
+    return _context.with_path_tracking(std::forward<F>(f));
+}
+
+constexpr bool subctx::reuse() const
+{
+    return _context.reuse();
+}
+
+inline std::pmr::memory_resource* subctx::resource() const
+{
+    return _context.resource();
+}
+
 } // namespace sdbus
 
 #endif /* sdbus_CONTEXT_HPP_ */
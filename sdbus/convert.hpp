@@ -0,0 +1,80 @@
+#ifndef sdbus_CONVERT_HPP_
+#define sdbus_CONVERT_HPP_
+
+#include <sdbus/concepts.hpp>
+
+#include <cstring>
+#include <iterator>
+
+namespace sdbus
+{
+
+/*
+ * In-message representation of a basic type: booleans take four bytes.
+ */
+template <typename T>
+using wire_type_t = std::conditional_t<std::same_as<T, bool>, uint32_t, T>;
+
+/*
+ * Converts `count` basic values between arrays in one pass. Contiguous
+ * destinations get a plain indexed loop over restrict pointers, which the
+ * compiler vectorizes for widening, narrowing and int <-> double; equal
+ * types are copied. Other iterators (std::vector<bool>, std::deque) are
+ * filled element by element.
+ */
+template <typename S, typename D>
+static void convert_elements(const S* __restrict src, size_t count, D* __restrict dst)
+{
+    if constexpr (std::same_as<S, D>)
+    {
+        if (count)
+        {
+            std::memcpy(dst, src, count * sizeof(S));
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            dst[i] = static_cast<D>(src[i]);
+        }
+    }
+}
+
+template <typename S, typename It>
+static void convert_elements(const S* src, size_t count, It dst)
+{
+    using value_type = std::iter_value_t<It>;
+
+    if constexpr (std::contiguous_iterator<It>)
+    {
+        convert_elements(src, count, std::to_address(dst));
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i, ++dst)
+        {
+            *dst = static_cast<value_type>(src[i]);
+        }
+    }
+}
+
+template <typename It, typename D>
+static void convert_elements(It src, size_t count, D* dst)
+{
+    if constexpr (std::contiguous_iterator<It>)
+    {
+        convert_elements(std::to_address(src), count, dst);
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i, ++src)
+        {
+            dst[i] = static_cast<D>(*src);
+        }
+    }
+}
+
+} // namespace sdbus
+
+#endif // sdbus_CONVERT_HPP_
@@ -0,0 +1,286 @@
+#ifndef sdbus_FD_HPP_
+#define sdbus_FD_HPP_
+
+#include <sdbus/sdbus.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <span>
+#include <system_error>
+#include <utility>
+
+namespace sdbus
+{
+
+/*
+ * An owned unix file descriptor ('h'). sd-bus duplicates descriptors it is
+ * given and closes the ones it received with the message, so both
+ * directions work on a private duplicate.
+ */
+struct unix_fd
+{
+    constexpr unix_fd() noexcept = default;
+
+    constexpr explicit unix_fd(int fd) noexcept : _fd(fd)
+    {}
+
+    unix_fd(unix_fd&& other) noexcept : _fd(other.release())
+    {}
+
+    unix_fd& operator=(unix_fd&& other) noexcept
+    {
+        reset(other.release());
+        return *this;
+    }
+
+    ~unix_fd()
+    {
+        reset();
+    }
+
+    constexpr int get() const noexcept
+    {
+        return _fd;
+    }
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return _fd >= 0;
+    }
+
+    int release() noexcept
+    {
+        return std::exchange(_fd, -1);
+    }
+
+    void reset(int fd = -1) noexcept
+    {
+        if (_fd >= 0)
+        {
+            ::close(_fd);
+        }
+        _fd = fd;
+    }
+
+    static unix_fd dup(int fd) noexcept
+    {
+        return unix_fd(::fcntl(fd, F_DUPFD_CLOEXEC, 3));
+    }
+
+  private:
+    int _fd = -1;
+};
+
+template <>
+struct default_traits<unix_fd>
+{
+    static constexpr auto sig = sig_string("h");
+
+    static errc read_value(subctx& ctx, unix_fd& v)
+    {
+        int fd;
+        auto ec = read_basic_impl(ctx, sig, &fd);
+        if (no_error(ec))
+        {
+            v = unix_fd::dup(fd);
+            if (!v)
+            {
+                ec = errc::read_error;
+            }
+        }
+        return ec;
+    }
+
+    static errc write_value(subctx& ctx, const unix_fd& v)
+    {
+        int fd = v.get();
+        return write_basic_impl(ctx, sig, &fd);
+    }
+};
+
+/*
+ * A read-only blob in a sealed memfd, passed by descriptor ('h') so that
+ * neither the broker nor the receiver copies the bytes: the receiver maps
+ * the same pages. The seals guarantee the mapping can't change or shrink
+ * under the reader.
+ *
+ *   auto frame = sdbus::memfd_payload::create("frame", size, [&](std::span<uint8_t> buf) {
+ *       capture(buf);
+ *   });
+ */
+struct memfd_payload
+{
+    static constexpr unsigned required_seals = F_SEAL_SEAL | F_SEAL_SHRINK | F_SEAL_GROW |
+                                               F_SEAL_WRITE;
+
+    memfd_payload() = default;
+
+    memfd_payload(memfd_payload&& other) noexcept :
+        _fd(std::move(other._fd)), _data(std::exchange(other._data, {}))
+    {}
+
+    memfd_payload& operator=(memfd_payload&& other) noexcept
+    {
+        unmap();
+        _fd = std::move(other._fd);
+        _data = std::exchange(other._data, {});
+        return *this;
+    }
+
+    ~memfd_payload()
+    {
+        unmap();
+    }
+
+    /*
+     * Creates a payload of `size` bytes, lets `fill` write them through a
+     * temporary shared mapping and seals the memfd. Throws std::system_error.
+     */
+    template <typename F>
+    static memfd_payload create(const char* name, size_t size, F&& fill)
+    {
+        unix_fd fd(::memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING));
+        if (!fd || ::ftruncate(fd.get(), size) < 0)
+        {
+            throw_errno();
+        }
+
+        if (size)
+        {
+            auto p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd.get(), 0);
+            if (p == MAP_FAILED)
+            {
+                throw_errno();
+            }
+            try
+            {
+                fill(std::span<uint8_t>(static_cast<uint8_t*>(p), size));
+            }
+            catch (...)
+            {
+                ::munmap(p, size);
+                throw;
+            }
+            // F_SEAL_WRITE is refused while a writable shared mapping exists.
+            ::munmap(p, size);
+        }
+
+        if (::fcntl(fd.get(), F_ADD_SEALS, required_seals) < 0)
+        {
+            throw_errno();
+        }
+
+        memfd_payload payload;
+        if (is_error(payload.map(std::move(fd))))
+        {
+            throw_errno();
+        }
+        return payload;
+    }
+
+    static memfd_payload create(const char* name, std::span<const uint8_t> data)
+    {
+        return create(name, data.size(), [&](std::span<uint8_t> buf) {
+            std::memcpy(buf.data(), data.data(), data.size());
+        });
+    }
+
+    constexpr std::span<const uint8_t> data() const noexcept
+    {
+        return _data;
+    }
+
+    constexpr size_t size() const noexcept
+    {
+        return _data.size();
+    }
+
+    constexpr const unix_fd& fd() const noexcept
+    {
+        return _fd;
+    }
+
+    /*
+     * Takes a received descriptor, checks that it is a fully sealed memfd
+     * and maps it read-only. On failure the payload is left empty.
+     */
+    errc map(unix_fd&& fd) noexcept
+    {
+        unmap();
+        _fd.reset();
+
+        auto seals = ::fcntl(fd.get(), F_GET_SEALS);
+        if (seals < 0 || (seals & required_seals) != required_seals)
+        {
+            return errc::invalid_type;
+        }
+
+        struct stat st;
+        if (::fstat(fd.get(), &st) < 0)
+        {
+            return errc::read_error;
+        }
+
+        auto size = static_cast<size_t>(st.st_size);
+        if (size)
+        {
+            auto p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd.get(), 0);
+            if (p == MAP_FAILED)
+            {
+                return errno == ENOMEM ? errc::no_memory : errc::read_error;
+            }
+            _data = {static_cast<const uint8_t*>(p), size};
+        }
+
+        _fd = std::move(fd);
+        return errc::success;
+    }
+
+  private:
+    void unmap() noexcept
+    {
+        if (!_data.empty())
+        {
+            ::munmap(const_cast<uint8_t*>(_data.data()), _data.size());
+            _data = {};
+        }
+    }
+
+    [[noreturn]] static void throw_errno()
+    {
+        throw std::system_error(std::error_code(errno, std::system_category()));
+    }
+
+    unix_fd _fd;
+    std::span<const uint8_t> _data;
+};
+
+template <>
+struct default_traits<memfd_payload>
+{
+    static constexpr auto sig = traits<unix_fd>::sig;
+
+    static errc read_value(subctx& ctx, memfd_payload& v)
+    {
+        unix_fd fd;
+        auto ec = traits<unix_fd>::read_value(ctx, fd);
+        if (no_error(ec))
+        {
+            ec = v.map(std::move(fd));
+        }
+        return ec;
+    }
+
+    static errc write_value(subctx& ctx, const memfd_payload& v)
+    {
+        return traits<unix_fd>::write_value(ctx, v.fd());
+    }
+};
+
+} // namespace sdbus
+
+#endif // sdbus_FD_HPP_
@@ -6,9 +6,22 @@
 
 #include <cstdint>
 
+// Set by the build for the library and its users alike, see meson.build.
+#ifndef SDBUS_INLINE_CODEC
+#define SDBUS_INLINE_CODEC 1
+#endif
+
 namespace sdbus
 {
 
+/*
+ * Codec policy: when set, nested readers and writers are invoked directly
+ * from header templates so the whole encode/decode call tree can be
+ * inlined; otherwise they go through the out-of-line, type-erased *_impl
+ * functions, which keeps code size down.
+ */
+static constexpr bool inline_codec = SDBUS_INLINE_CODEC;
+
 struct subctx;
 
 template <typename T>
@@ -33,20 +46,37 @@ template <typename T>
 struct traits : default_traits<T>
 {};
 
+/*
+ * Traits of T as an array element, where pairs with a basic key are dict
+ * entries rather than structs.
+ */
+template <typename T>
+struct element_traits : traits<T>
+{};
+
 struct reader_base;
 struct writer_base;
+struct range_writer_base;
 
 errc sdbus_errc(int ret);
 
 errc read_basic_impl(subctx&, const char*, void*);
 errc read_variant_impl(subctx&, reader_base&);
 errc read_dict_entry_impl(subctx&, reader_base&);
+errc read_struct_impl(subctx&, reader_base&);
 errc read_array_impl(subctx&, reader_base&);
+errc read_basic_array_impl(subctx&, const char*, const void**, size_t*);
+errc read_array_size_impl(subctx&, size_t*);
 
 errc write_basic_impl(subctx&, const char*, const void*);
 errc write_variant_impl(subctx&, const char*, writer_base&);
 errc write_dict_entry_impl(subctx&, const char*, writer_base&);
+errc write_struct_impl(subctx&, const char*, writer_base&);
 errc write_array_impl(subctx&, const char*, size_t, writer_base&);
+errc write_range_impl(subctx&, const char*, range_writer_base&);
+errc write_basic_array_impl(subctx&, const char*, const void*, size_t);
+errc write_string_space_impl(subctx&, size_t, char**);
+errc write_array_space_impl(subctx&, const char*, size_t, void**);
 
 errc read_basic(subctx&, bool&);
 errc read_basic(subctx&, uint8_t&);
@@ -98,6 +128,99 @@ static errc read_array(subctx& ctx, T& v);
 template <typename T>
 static errc write_array(subctx& ctx, const T& v);
 
+template <typename R>
+static errc write_range(subctx& ctx, R& v);
+
+template <typename T>
+static errc read_basic_array(subctx& ctx, T& v);
+
+template <typename T>
+static errc write_basic_array(subctx& ctx, const T& v);
+
+template <typename T>
+static errc read_basic_view(subctx& ctx, T& v);
+
+template <typename S, typename T>
+static errc read_converted_array(subctx& ctx, T& v);
+
+template <typename S, typename T>
+static errc write_converted_array(subctx& ctx, const T& v);
+
+template <typename T>
+static errc write_bool_array(subctx& ctx, const T& v);
+
+/*
+ * Standalone wire codec, see wire.hpp. Traits reach it through their
+ * encode_value()/decode_value() hooks.
+ */
+namespace wire
+{
+
+struct encoder;
+struct decoder;
+
+template <typename T>
+static errc encode(encoder& e, const T& v);
+
+template <typename T>
+static errc decode(decoder& d, T& v);
+
+template <typename T>
+static errc encode_basic(encoder& e, const T& v);
+
+template <typename T>
+static errc decode_basic(decoder& d, T& v);
+
+template <typename T>
+static errc encode_string(encoder& e, const T& v);
+
+template <typename T>
+static errc decode_string(decoder& d, T& v);
+
+template <typename T>
+static errc encode_variant(encoder& e, const T& v);
+
+template <typename T>
+static errc decode_variant(decoder& d, T& v);
+
+template <typename T>
+static errc encode_struct(encoder& e, const T& v);
+
+template <typename T>
+static errc decode_struct(decoder& d, T& v);
+
+template <typename T>
+static errc encode_dict_entry(encoder& e, const T& v);
+
+template <typename T>
+static errc decode_dict_entry(decoder& d, T& v);
+
+template <typename T>
+static errc encode_array(encoder& e, const T& v);
+
+template <typename T>
+static errc decode_array(decoder& d, T& v);
+
+template <typename T>
+static errc encode_dict(encoder& e, const T& v);
+
+template <typename T>
+static errc decode_dict(decoder& d, T& v);
+
+template <typename T>
+static errc encode_as(encoder& e, const T& v);
+
+template <typename T>
+static errc decode_as(decoder& d, T& v);
+
+template <typename T>
+static errc encode_array_of(encoder& e, const T& v);
+
+template <typename T>
+static errc decode_array_of(decoder& d, T& v);
+
+} // namespace wire
+
 } // namespace sdbus
 
 #endif /* sdbus_FORWARDS_HPP_ */
@@ -3,7 +3,11 @@
 
 #include <sdbus/forwards.hpp>
 
+#include <array>
+#include <span>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace sdbus
 {
@@ -149,7 +153,7 @@ struct basic_read_helper<as_helper<T, F>>
     constexpr basic_read_helper(as_helper<T, F> h) : _ref(h.ref)
     {}
 
-    constexpr reference ref() const
+    constexpr reference ref()
     {
         return _value;
     }
@@ -236,41 +240,60 @@ struct string_read_helper<as_helper<T, F>>
     F& _ref;
 };
 
+/*
+ * Whether a string source is known to be NUL-terminated, so that its data
+ * can be handed to sd-bus as a C string.
+ */
+template <typename T>
+static constexpr bool nul_terminated =
+    std::is_pointer_v<std::decay_t<T>> || requires(const T& v) { v.c_str(); };
+
 template <typename T>
 struct string_write_helper
 {
-    constexpr explicit string_write_helper(const T& v) : _data(std::string_view(v).data())
+    static constexpr bool terminated = nul_terminated<T>;
+
+    constexpr explicit string_write_helper(const T& v) : _data(std::string_view(v))
     {}
     constexpr const char* sig() const
     {
         return traits<T>::sig;
     }
     constexpr const char* data() const
+    {
+        return _data.data();
+    }
+    constexpr std::string_view view() const
     {
         return _data;
     }
 
   private:
-    const char* _data;
+    std::string_view _data;
 };
 
 template <typename T, typename F>
 struct string_write_helper<as_helper<T, F>>
 {
-    constexpr explicit string_write_helper(const as_helper<T, F>& wh) :
-        _data(std::string_view(wh.ref).data())
+    static constexpr bool terminated = nul_terminated<F>;
+
+    constexpr explicit string_write_helper(const as_helper<T, F>& wh) : _data(std::string_view(wh.ref))
     {}
     constexpr const char* sig() const
     {
         return traits<T>::sig;
     }
     constexpr const char* data() const
+    {
+        return _data.data();
+    }
+    constexpr std::string_view view() const
     {
         return _data;
     }
 
   private:
-    const char* _data;
+    std::string_view _data;
 };
 
 template <typename C, typename V>
@@ -287,6 +310,71 @@ static constexpr auto as_array_of(C&& v)
     return array_of_helper<type, as_helper<V, value_type>>(std::forward<C>(v));
 }
 
+/*
+ * Opts an array read into a pre-scan that counts its elements, so that a
+ * container with reserve() is sized once before decoding. The scan walks
+ * the array an extra time; callers that know the size can reserve instead.
+ *
+ *   read(ctx, presized(names));
+ */
+template <typename C>
+struct presized_helper
+{
+    C& ref;
+};
+
+template <typename C>
+static constexpr auto presized(C& v)
+{
+    return presized_helper<C>{v};
+}
+
+/*
+ * Emplacement helpers: instead of copying a finished value into the
+ * message, sd-bus reserves the space and `fill` writes straight into it.
+ *
+ *   write(ctx, emplace_string(n, [&](std::span<char> buf) { format(buf, value); }));
+ *   write(ctx, emplace_array<uint32_t>(n, [&](std::span<uint32_t> buf) { ... }));
+ *   write(ctx, concat(prefix, "/", name));
+ */
+template <typename F>
+struct string_emplace_helper
+{
+    size_t size;
+    F fill;
+};
+
+template <typename F>
+static constexpr auto emplace_string(size_t size, F&& fill)
+{
+    return string_emplace_helper<std::decay_t<F>>{size, std::forward<F>(fill)};
+}
+
+template <typename T, typename F>
+struct array_emplace_helper
+{
+    size_t count;
+    F fill;
+};
+
+template <typename T, typename F>
+static constexpr auto emplace_array(size_t count, F&& fill)
+{
+    return array_emplace_helper<T, std::decay_t<F>>{count, std::forward<F>(fill)};
+}
+
+template <size_t N>
+struct concat_helper
+{
+    std::array<std::string_view, N> parts;
+};
+
+template <typename... Ts>
+static constexpr auto concat(const Ts&... parts)
+{
+    return concat_helper<sizeof...(Ts)>{{std::string_view(parts)...}};
+}
+
 } // namespace sdbus
 
 #endif // sdbus_HELPERS_HPP_
@@ -0,0 +1,317 @@
+#ifndef sdbus_INTERN_HPP_
+#define sdbus_INTERN_HPP_
+
+#include <sdbus/sdbus.hpp>
+
+#include <algorithm>
+#include <compare>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_set>
+
+namespace sdbus
+{
+
+/*
+ * A handle to a string in the process-wide intern pool. Equal strings get
+ * the same handle, so comparing and hashing don't look at the characters.
+ * Decoding an 's' or 'o' into a handle hashes the string in the message
+ * buffer and allocates only the first time a string is seen. Interned
+ * strings are never released, see intern_pool.
+ *
+ *   std::unordered_map<sdbus::interned_string, state> by_interface;
+ */
+struct interned_string
+{
+    struct entry
+    {
+        uint64_t hash;
+        std::string_view str; // NUL-terminated
+    };
+
+    constexpr interned_string() noexcept = default;
+
+    constexpr explicit interned_string(const entry* e) noexcept : _e(e)
+    {}
+
+    explicit interned_string(std::string_view s);
+
+    interned_string& operator=(std::string_view s);
+
+    constexpr std::string_view view() const noexcept
+    {
+        return _e->str;
+    }
+
+    constexpr const char* c_str() const noexcept
+    {
+        return _e->str.data();
+    }
+
+    constexpr size_t size() const noexcept
+    {
+        return _e->str.size();
+    }
+
+    constexpr bool empty() const noexcept
+    {
+        return _e->str.empty();
+    }
+
+    constexpr uint64_t hash() const noexcept
+    {
+        return _e->hash;
+    }
+
+    constexpr operator std::string_view() const noexcept
+    {
+        return view();
+    }
+
+    friend constexpr bool operator==(interned_string a, interned_string b) noexcept
+    {
+        return a._e == b._e;
+    }
+
+    friend constexpr bool operator==(interned_string a, std::string_view b) noexcept
+    {
+        return a.view() == b;
+    }
+
+    // Orders by contents so that ordered containers iterate predictably.
+    friend constexpr std::strong_ordering operator<=>(interned_string a, interned_string b) noexcept
+    {
+        return a._e == b._e ? std::strong_ordering::equal : a.view() <=> b.view();
+    }
+
+    static constexpr entry empty_entry{string_hash(""), ""};
+
+  private:
+    const entry* _e = &empty_entry;
+};
+
+static_assert(sizeof(interned_string) == sizeof(void*));
+
+using interned_objpath = basic_objpath<interned_string>;
+
+/*
+ * Insert-only string pool. Entries live in an arena and are never freed,
+ * which is what keeps handles valid for the life of the process and lets
+ * them be compared by pointer. The flip side is that the pool only grows,
+ * and decoded names come from peers: the pool therefore has a byte limit,
+ * past which unknown strings are refused with errc::out_of_space rather
+ * than added. Known strings keep resolving. Size the limit for the names a
+ * service expects to see and keep free-form strings in std::string.
+ *
+ * Lookups take a shared lock and go through the hash of the string, so
+ * finding a known string neither allocates nor serializes readers.
+ */
+class intern_pool
+{
+  public:
+    using entry = interned_string::entry;
+
+    static constexpr size_t default_limit = 4 << 20;
+
+    explicit intern_pool(size_t limit = default_limit) : _limit(limit)
+    {}
+
+    intern_pool(const intern_pool&) = delete;
+    intern_pool& operator=(const intern_pool&) = delete;
+
+    errc intern(std::string_view s, interned_string& v)
+    {
+        if (s.empty())
+        {
+            v = interned_string();
+            return errc::success;
+        }
+
+        key k{string_hash(s), s};
+        {
+            std::shared_lock lock(_mutex);
+            auto it = _index.find(k);
+            if (it != _index.end())
+            {
+                v = interned_string(*it);
+                return errc::success;
+            }
+        }
+
+        std::unique_lock lock(_mutex);
+        auto it = _index.find(k);
+        if (it != _index.end())
+        {
+            v = interned_string(*it);
+            return errc::success;
+        }
+
+        auto cost = sizeof(entry) + s.size() + 1;
+        if (cost > _limit - std::min(_limit, _bytes))
+        {
+            return errc::out_of_space;
+        }
+
+        try
+        {
+            auto chars = static_cast<char*>(_arena.allocate(s.size() + 1, 1));
+            std::memcpy(chars, s.data(), s.size());
+            chars[s.size()] = '\0';
+            auto e = new (_arena.allocate(sizeof(entry), alignof(entry)))
+                entry{k.hash, std::string_view(chars, s.size())};
+            _index.insert(e);
+            _bytes += cost;
+            v = interned_string(e);
+        }
+        catch (std::bad_alloc&)
+        {
+            return errc::no_memory;
+        }
+        return errc::success;
+    }
+
+    // Throws std::system_error when the string can't be added.
+    interned_string intern(std::string_view s)
+    {
+        interned_string v;
+        auto ec = intern(s, v);
+        if (is_error(ec))
+        {
+            throw std::system_error(std::make_error_code(ec));
+        }
+        return v;
+    }
+
+    size_t size() const
+    {
+        std::shared_lock lock(_mutex);
+        return _index.size();
+    }
+
+    // Bytes taken by entries, counted against the limit.
+    size_t bytes() const
+    {
+        std::shared_lock lock(_mutex);
+        return _bytes;
+    }
+
+    void set_limit(size_t limit)
+    {
+        std::unique_lock lock(_mutex);
+        _limit = limit;
+    }
+
+    static intern_pool& global()
+    {
+        static intern_pool pool;
+        return pool;
+    }
+
+  private:
+    struct key
+    {
+        uint64_t hash;
+        std::string_view str;
+    };
+
+    static constexpr const key& as_key(const key& k) noexcept
+    {
+        return k;
+    }
+
+    static constexpr key as_key(const entry* e) noexcept
+    {
+        return {e->hash, e->str};
+    }
+
+    struct key_hash
+    {
+        using is_transparent = void;
+
+        size_t operator()(const auto& v) const noexcept
+        {
+            return as_key(v).hash;
+        }
+    };
+
+    struct key_equal
+    {
+        using is_transparent = void;
+
+        bool operator()(const auto& a, const auto& b) const noexcept
+        {
+            return as_key(a).hash == as_key(b).hash && as_key(a).str == as_key(b).str;
+        }
+    };
+
+    mutable std::shared_mutex _mutex;
+    size_t _limit;
+    size_t _bytes = 0;
+    std::pmr::monotonic_buffer_resource _arena;
+    std::unordered_set<const entry*, key_hash, key_equal> _index;
+};
+
+inline interned_string::interned_string(std::string_view s) :
+    interned_string(intern_pool::global().intern(s))
+{}
+
+inline interned_string& interned_string::operator=(std::string_view s)
+{
+    return *this = intern_pool::global().intern(s);
+}
+
+template <typename T, sig_string Sig>
+struct default_interned_traits
+{
+    static constexpr auto sig = Sig;
+
+    static errc read_value(subctx& ctx, T& v)
+    {
+        const char* str;
+        auto ec = read_basic_impl(ctx, sig, &str);
+        if (no_error(ec))
+        {
+            interned_string tmp;
+            ec = intern_pool::global().intern(str, tmp);
+            if (no_error(ec))
+            {
+                v = tmp;
+            }
+        }
+        return ec;
+    }
+
+    static errc write_value(subctx& ctx, const T& v)
+    {
+        return write_basic_impl(ctx, sig, v.c_str());
+    }
+};
+
+template <>
+struct default_traits<interned_string> : default_interned_traits<interned_string, "s">
+{};
+
+template <>
+struct default_traits<interned_objpath> : default_interned_traits<interned_objpath, "o">
+{};
+
+} // namespace sdbus
+
+template <>
+struct std::hash<sdbus::interned_string>
+{
+    size_t operator()(sdbus::interned_string s) const noexcept
+    {
+        return s.hash();
+    }
+};
+
+template <>
+struct std::hash<sdbus::interned_objpath> : std::hash<sdbus::interned_string>
+{};
+
+#endif // sdbus_INTERN_HPP_
@@ -5,7 +5,11 @@
 
 #include <sdbus/sdbus.hpp>
 
+#include <iterator>
+#include <ranges>
 #include <system_error>
+#include <tuple>
+#include <utility>
 
 namespace sdbus
 {
@@ -74,8 +78,7 @@ class message
     {
         // printf("MESSAGE(%p): MOVE FROM m=%p o = %p\n", static_cast<void*>(this),
         //        static_cast<void*>(m._m), static_cast<void*>(&m));
-        _m = m._m;
-        m._m = nullptr;
+        std::swap(_m, m._m);
         return *this;
     }
     operator bool() const
@@ -98,6 +101,19 @@ class message
     {
         sdbus::write(_m, std::forward<T>(v));
     }
+    /*
+     * Appends all arguments at once, see write_all().
+     */
+    template <typename... T>
+    void append_all(const T&... v) const
+    {
+        auto ec = sdbus::write_all(_m, v...);
+        if (is_error(ec))
+        {
+            throw std::system_error(std::make_error_code(ec));
+        }
+    }
+
     ref_wrapper reference()
     {
         return ref_wrapper(_m);
@@ -111,6 +127,21 @@ class message
         return v;
     }
 
+    /*
+     * Reads the whole argument list at once, see read_all().
+     */
+    template <typename... T>
+    std::tuple<T...> read_all() const
+    {
+        std::tuple<T...> v;
+        auto ec = std::apply([this](auto&... args) { return sdbus::read_all(_m, args...); }, v);
+        if (is_error(ec))
+        {
+            throw std::system_error(std::make_error_code(ec));
+        }
+        return v;
+    }
+
     struct container_scope
     {
         container_scope() = delete;
@@ -129,6 +160,12 @@ class message
             }
         }
 
+        // Leaves the container open, its exit becomes the caller's job.
+        void release()
+        {
+            _exit = false;
+        }
+
       private:
         const message& _m;
         bool _exit = true;
@@ -139,6 +176,165 @@ class message
         return enter_container(SD_BUS_TYPE_ARRAY);
     }
 
+    /*
+     * Input range over the array at the read position that decodes one
+     * element per increment. The array is exited when the range goes away,
+     * so iteration may stop early; the rest of the array is skipped.
+     *
+     *   for (auto& v : msg.range<std::string>() | std::views::filter(pred))
+     */
+    template <typename T>
+    class array_range : public std::ranges::view_interface<array_range<T>>
+    {
+      public:
+        class iterator
+        {
+          public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            explicit iterator(array_range* range) : _range(range)
+            {}
+
+            T& operator*() const
+            {
+                return _range->_value;
+            }
+
+            iterator& operator++()
+            {
+                _range->next();
+                return *this;
+            }
+
+            void operator++(int)
+            {
+                ++*this;
+            }
+
+            friend bool operator==(const iterator& it, std::default_sentinel_t)
+            {
+                return it.done();
+            }
+
+          private:
+            bool done() const
+            {
+                return _range->_done;
+            }
+
+            array_range* _range = nullptr;
+        };
+
+        array_range(const message& m) : _m(&m)
+        {
+            m.enter_container(SD_BUS_TYPE_ARRAY, element_traits<T>::sig).release();
+        }
+
+        array_range(array_range&& r) :
+            _m(std::exchange(r._m, nullptr)), _value(std::move(r._value)), _done(r._done)
+        {}
+
+        array_range& operator=(array_range&& r)
+        {
+            std::swap(_m, r._m);
+            std::swap(_value, r._value);
+            std::swap(_done, r._done);
+            return *this;
+        }
+
+        ~array_range()
+        {
+            leave();
+        }
+
+        /*
+         * Skips the elements that were not visited and exits the array,
+         * reporting failures that the destructor has to swallow.
+         */
+        void close()
+        {
+            auto err = leave();
+            if (err < 0)
+            {
+                throw std::system_error(std::error_code(-err, std::system_category()));
+            }
+        }
+
+        iterator begin()
+        {
+            next();
+            return iterator(this);
+        }
+
+        std::default_sentinel_t end() const
+        {
+            return {};
+        }
+
+      private:
+        // sd-bus only exits an array once its read position is at the end.
+        int leave() noexcept
+        {
+            if (!_m)
+            {
+                return 0;
+            }
+            sd_bus_message* msg = *std::exchange(_m, nullptr);
+
+            int err;
+            while ((err = sd_bus_message_at_end(msg, 0)) == 0)
+            {
+                err = sd_bus_message_skip(msg, nullptr);
+                if (err < 0)
+                {
+                    return err;
+                }
+            }
+            if (err < 0)
+            {
+                return err;
+            }
+            return sd_bus_message_exit_container(msg);
+        }
+
+        // A closed or moved-from range has no elements left.
+        void next()
+        {
+            if (!_m || _m->at_end())
+            {
+                _done = true;
+                return;
+            }
+
+            // Elements are decoded into the same object to keep its storage.
+            if constexpr (concepts::Dict<T>)
+            {
+                _value = T{};
+            }
+            context<error_policy::fail_fast> ctx(*_m);
+            ctx.set_reuse(true);
+            auto ec = element_traits<T>::read_value(ctx, _value);
+            if (is_error(ec))
+            {
+                throw std::system_error(std::make_error_code(ec));
+            }
+        }
+
+        const message* _m;
+        T _value{};
+        bool _done = false;
+    };
+
+    template <typename T>
+    array_range<T> range() const
+    {
+        return array_range<T>(*this);
+    }
+
     bool at_end(bool complete = false) const
     {
         auto err = sd_bus_message_at_end(_m, complete);
@@ -150,9 +346,9 @@ class message
     }
 
   private:
-    container_scope enter_container(char type) const
+    container_scope enter_container(char type, const char* contents = nullptr) const
     {
-        auto err = sd_bus_message_enter_container(_m, type, nullptr);
+        auto err = sd_bus_message_enter_container(_m, type, contents);
         if (err < 0)
         {
             throw std::system_error(std::error_code(err, std::system_category()));
@@ -0,0 +1,180 @@
+#ifndef sdbus_PERFECT_HASH_HPP_
+#define sdbus_PERFECT_HASH_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <numeric>
+#include <string_view>
+
+namespace sdbus
+{
+
+constexpr uint64_t string_hash(std::string_view s) noexcept
+{
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (char c : s)
+    {
+        h = (h ^ static_cast<uint8_t>(c)) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+constexpr uint32_t mix_hash(uint64_t h, uint32_t seed) noexcept
+{
+    h ^= seed * 0x9E3779B97F4A7C15ull;
+    h = (h ^ (h >> 33)) * 0xFF51AFD7ED558CCDull;
+    h = (h ^ (h >> 33)) * 0xC4CEB9FE1A85EC53ull;
+    return static_cast<uint32_t>(h ^ (h >> 33));
+}
+
+/*
+ * Compile-time perfect hash over a fixed set of keys: keys are grouped
+ * into buckets by a primary hash, and each bucket gets a seed that places
+ * all of its keys into distinct slots. A lookup costs one pass over the
+ * key, two mixes and a single string comparison.
+ */
+template <size_t N>
+struct perfect_hash
+{
+    static constexpr size_t buckets = std::bit_ceil(N ? N : 1);
+    static constexpr size_t slots = buckets * 2;
+    static constexpr uint16_t npos = 0xFFFF;
+    static constexpr uint32_t max_seed = 0x1000;
+
+    static_assert(N < npos, "Too many keys.");
+
+    constexpr perfect_hash(const std::array<std::string_view, N>& keys) : _keys(keys)
+    {
+        _slots.fill(npos);
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            for (size_t j = i + 1; j < N; ++j)
+            {
+                if (keys[i] == keys[j])
+                {
+                    return;
+                }
+            }
+        }
+        _unique = true;
+
+        std::array<uint64_t, N> hashes{};
+        std::array<size_t, N> bucket_of{};
+        std::array<size_t, buckets> count{};
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            hashes[i] = string_hash(keys[i]);
+            bucket_of[i] = mix_hash(hashes[i], 0) & (buckets - 1);
+            ++count[bucket_of[i]];
+        }
+
+        // place the largest buckets first while the table is still sparse
+        std::array<size_t, buckets> order{};
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return count[a] > count[b]; });
+
+        for (auto b : order)
+        {
+            if (count[b] == 0)
+            {
+                break;
+            }
+            if (!place(b, hashes, bucket_of))
+            {
+                return;
+            }
+        }
+
+        _valid = true;
+    }
+
+    // The keys are unique and every bucket found a seed.
+    constexpr bool valid() const noexcept
+    {
+        return _valid;
+    }
+
+    // False for duplicate keys; valid() can still fail when no seed below max_seed places a bucket.
+    constexpr bool unique() const noexcept
+    {
+        return _unique;
+    }
+
+    // Returns the key index, or N when the key is not in the set.
+    constexpr size_t find(std::string_view key) const noexcept
+    {
+        auto h = string_hash(key);
+        auto b = mix_hash(h, 0) & (buckets - 1);
+        auto i = _slots[mix_hash(h, _seeds[b]) & (slots - 1)];
+
+        if (i != npos && _keys[i] == key)
+        {
+            return i;
+        }
+
+        return N;
+    }
+
+    constexpr std::string_view key(size_t i) const noexcept
+    {
+        return _keys[i];
+    }
+
+  private:
+    constexpr bool place(size_t b, const std::array<uint64_t, N>& hashes,
+                         const std::array<size_t, N>& bucket_of)
+    {
+        for (uint32_t seed = 1; seed < max_seed; ++seed)
+        {
+            std::array<size_t, N> placed{};
+            size_t n = 0;
+            bool fits = true;
+
+            for (size_t i = 0; i < N && fits; ++i)
+            {
+                if (bucket_of[i] != b)
+                {
+                    continue;
+                }
+
+                auto s = mix_hash(hashes[i], seed) & (slots - 1);
+                if (_slots[s] != npos)
+                {
+                    fits = false;
+                }
+                else
+                {
+                    _slots[s] = static_cast<uint16_t>(i);
+                    placed[n++] = s;
+                }
+            }
+
+            if (fits)
+            {
+                _seeds[b] = static_cast<uint16_t>(seed);
+                return true;
+            }
+
+            while (n)
+            {
+                _slots[placed[--n]] = npos;
+            }
+        }
+
+        return false;
+    }
+
+    std::array<std::string_view, N> _keys{};
+    std::array<uint16_t, buckets> _seeds{};
+    std::array<uint16_t, slots> _slots{};
+    bool _unique = false;
+    bool _valid = false;
+};
+
+} // namespace sdbus
+
+#endif // sdbus_PERFECT_HASH_HPP_
@@ -3,9 +3,12 @@
 
 #include <sdbus/context.hpp>
 #include <sdbus/helpers.hpp>
+#include <sdbus/perfect_hash.hpp>
 
+#include <bitset>
 #include <span>
 #include <string_view>
+#include <type_traits>
 
 namespace sdbus
 {
@@ -81,6 +84,201 @@ struct property_desc_maker<std::tuple<T, Ts...>>
     }
 };
 
+template <typename T>
+struct property_table
+{
+    static constexpr auto descs = property_desc_maker<typename T::dict_t>::make_descs();
+
+    using desc_type = typename decltype(descs)::value_type;
+
+    static constexpr const desc_type* find(std::string_view name)
+    {
+        auto i = index.find(name);
+        return i < descs.size() ? &descs[i] : nullptr;
+    }
+
+    static constexpr size_t index_of(const desc_type* desc)
+    {
+        return desc - descs.data();
+    }
+
+  private:
+    static constexpr auto make_index()
+    {
+        std::array<std::string_view, descs.size()> names;
+        for (size_t i = 0; i < descs.size(); ++i)
+        {
+            names[i] = descs[i].name();
+        }
+        return perfect_hash<descs.size()>(names);
+    }
+
+    static constexpr auto index = make_index();
+
+    static_assert(index.unique(), "Property names must be unique.");
+    static_assert(!index.unique() || index.valid(),
+                  "No perfect hash for the property names, raise perfect_hash::max_seed.");
+};
+
+template <typename T>
+using property_mask = std::bitset<property_table<std::remove_const_t<T>>::descs.size()>;
+
+/*
+ * A Dict struct restricted to a subset of its properties: only the selected
+ * ones are written, or decoded with all other entries skipped in the message.
+ */
+template <typename T>
+struct projection
+{
+    T& ref;
+    property_mask<T> mask;
+};
+
+template <sig_string... Names, typename T>
+static constexpr auto project(T& v)
+{
+    using table = property_table<std::remove_const_t<T>>;
+
+    static_assert(((table::find(Names) != nullptr) && ...), "Unknown property.");
+
+    constexpr auto mask = [] {
+        property_mask<T> m;
+        (m.set(table::index_of(table::find(Names))), ...);
+        return m;
+    }();
+
+    return projection<T>{v, mask};
+}
+
+template <typename T>
+static constexpr auto project(T& v, const property_mask<T>& mask)
+{
+    return projection<T>{v, mask};
+}
+
+template <typename T>
+struct default_traits<projection<T>>
+{
+    static constexpr auto sig = traits<std::remove_const_t<T>>::sig;
+
+    static errc read_value(subctx& ctx, projection<T> v)
+    {
+        return read_array(ctx, v);
+    }
+
+    static errc write_value(subctx& ctx, const projection<T>& v)
+    {
+        return write_array(ctx, v);
+    }
+};
+
+/*
+ * The properties whose values differ between two snapshots of a Dict struct.
+ */
+template <typename T>
+static property_mask<T> changed(const T& a, const T& b)
+{
+    auto compare = [&]<typename... Ps>(std::type_identity<std::tuple<Ps...>>) {
+        property_mask<T> mask;
+        size_t i = 0;
+        ((mask[i++] = !(a.*Ps::pointer == b.*Ps::pointer)), ...);
+        return mask;
+    };
+    return compare(std::type_identity<typename T::dict_t>{});
+}
+
+/*
+ * A Dict struct that records which properties were modified since the last
+ * clear(), either through set() or by update() from a new snapshot, so that
+ * only those are sent, e.g. in PropertiesChanged.
+ */
+template <typename T>
+struct tracked
+{
+    tracked() = default;
+    tracked(T v) : _value(std::move(v))
+    {}
+
+    const T& value() const noexcept
+    {
+        return _value;
+    }
+
+    const T* operator->() const noexcept
+    {
+        return &_value;
+    }
+
+    template <sig_string Name, typename V>
+    void set(V&& v)
+    {
+        using table = property_table<T>;
+
+        static_assert(table::find(Name) != nullptr, "Unknown property.");
+
+        constexpr auto i = table::index_of(table::find(Name));
+        auto& field = _value.*std::tuple_element_t<i, typename T::dict_t>::pointer;
+        if (!(field == v))
+        {
+            field = std::forward<V>(v);
+            _dirty.set(i);
+        }
+    }
+
+    void update(const T& v)
+    {
+        _dirty |= changed(_value, v);
+        _value = v;
+    }
+
+    const property_mask<T>& dirty() const noexcept
+    {
+        return _dirty;
+    }
+
+    void clear() noexcept
+    {
+        _dirty.reset();
+    }
+
+    projection<const T> changes() const
+    {
+        return {_value, _dirty};
+    }
+
+  private:
+    T _value{};
+    property_mask<T> _dirty;
+};
+
+/*
+ * Names of the properties selected by a mask, written as an array of
+ * strings, e.g. the invalidated properties of PropertiesChanged.
+ */
+template <typename T>
+struct property_names
+{
+    property_mask<T> mask;
+};
+
+template <typename T>
+struct default_traits<property_names<T>>
+{
+    static constexpr auto sig = sig_string("as");
+
+    template <typename F>
+    static errc read_value(subctx&, F&&)
+    {
+        static_assert(false, "Can't read property names.");
+        return errc::read_error;
+    }
+
+    static errc write_value(subctx& ctx, const property_names<T>& v)
+    {
+        return write_array(ctx, v);
+    }
+};
+
 } // namespace sdbus
 
 #endif /* sdbus_PROPERTY_HPP_ */
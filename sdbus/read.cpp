@@ -74,101 +74,63 @@ errc read_basic(subctx& ctx, double& v)
 
 errc read_array_impl(subctx& ctx, reader_base& rdr)
 {
-    auto msg = ctx.msg();
-    auto ec = sdbus_errc(sd_bus_message_enter_container(msg, SD_BUS_TYPE_ARRAY, nullptr));
-    if (no_error(ec))
-    {
-        auto index = 0;
-
-        for (;;)
-        {
-            auto ret = sd_bus_message_at_end(msg, 0);
-            if (ret < 0)
-            {
-                return errc::read_error;
-            }
-            if (ret > 0)
-            {
-                break;
-            }
-
-            subctx ictx(index++, ctx);
-            ec = rdr.read_value(ictx);
-            if (is_error(ec))
-            {
-                ec = ictx.error(ec);
-                if (is_error(ec))
-                {
-                    break;
-                }
-                else
-                {
-                    sd_bus_message_skip(msg, nullptr);
-                }
-            }
-        }
-
-        if (sd_bus_message_exit_container(msg) < 0)
-        {
-            return errc::read_error;
-        }
-    }
+    return read_array_inline(ctx, rdr);
+}
 
-    return ec;
+errc read_basic_array_impl(subctx& ctx, const char* type, const void** data, size_t* size)
+{
+    *data = nullptr;
+    *size = 0;
+    return sdbus_errc(sd_bus_message_read_array(ctx.msg(), type[0], data, size));
 }
 
-errc read_variant_impl(subctx& ctx, reader_base& rdr)
+errc read_array_size_impl(subctx& ctx, size_t* size)
 {
     auto msg = ctx.msg();
-    auto ec = sdbus_errc(sd_bus_message_enter_container(msg, SD_BUS_TYPE_VARIANT, nullptr));
-    if (no_error(ec))
+
+    *size = 0;
+    for (;;)
     {
-        ec = rdr.read_value(ctx);
-        if (is_error(ec))
+        auto ret = sd_bus_message_at_end(msg, 0);
+        if (ret < 0)
         {
-            sd_bus_message_skip(msg, nullptr);
+            return errc::read_error;
         }
-        if (sd_bus_message_exit_container(msg) < 0)
+        if (ret > 0)
+        {
+            break;
+        }
+        if (sd_bus_message_skip(msg, nullptr) < 0)
         {
             return errc::read_error;
         }
+        ++*size;
     }
 
-    return ec;
+    return sdbus_errc(sd_bus_message_rewind(msg, 0));
+}
+
+errc read_variant_impl(subctx& ctx, reader_base& rdr)
+{
+    return read_variant_inline(ctx, rdr);
 }
 
 errc read_dict_entry_impl(subctx& ctx, reader_base& rdr)
 {
-    auto msg = ctx.msg();
-    auto ec = sdbus_errc(sd_bus_message_enter_container(msg, SD_BUS_TYPE_DICT_ENTRY, nullptr));
-    if (no_error(ec))
-    {
-        ec = rdr.read_value(ctx);
-        if (ec == errc::unknown_property)
-        {
-            ec = errc::success;
-        }
-        if (sd_bus_message_exit_container(msg) < 0)
-        {
-            return errc::read_error;
-        }
-    }
+    return read_dict_entry_inline(ctx, rdr);
+}
 
-    return ec;
+errc read_struct_impl(subctx& ctx, reader_base& rdr)
+{
+    return read_struct_inline(ctx, rdr);
 }
 
 errc variant_reader_base::read_value(subctx& ctx)
 {
-    const char* sig = sd_bus_message_get_signature(ctx.msg(), 0);
-
-    for (const auto& cb : _callbacks)
+    auto i = _index(sd_bus_message_get_signature(ctx.msg(), 0));
+    if (i < _callbacks.size())
     {
-        errc ec = errc::success;
-
-        if ((this->*cb)(ctx, sig, ec))
-        {
-            return ec;
-        }
+        return (this->*_callbacks[i])(ctx);
     }
 
     return errc::bad_variant;
@@ -176,28 +138,7 @@ errc variant_reader_base::read_value(subctx& ctx)
 
 errc dict_reader_base::read_value(subctx& ctx)
 {
-    auto msg = ctx.msg();
-    auto ec = sdbus_errc(sd_bus_message_enter_container(msg, SD_BUS_TYPE_DICT_ENTRY, nullptr));
-    if (no_error(ec))
-    {
-        const char* name;
-        ec = read(ctx, name);
-        if (no_error(ec))
-        {
-            ec = read_entry(ctx, name);
-        }
-        if (ec == errc::unknown_property)
-        {
-            sd_bus_message_skip(msg, 0);
-            ec = errc::success;
-        }
-        if (sd_bus_message_exit_container(msg) < 0)
-        {
-            return errc::read_error;
-        }
-    }
-
-    return ec;
+    return read_item(ctx, *this);
 }
 
 } // namespace sdbus
@@ -2,14 +2,37 @@
 #define sdbus_READ_HPP_
 
 #include <sdbus/concepts.hpp>
+#include <sdbus/convert.hpp>
 #include <sdbus/property.hpp>
+#include <sdbus/traits.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#if __has_include(<boost/container/container_fwd.hpp>)
+#include <boost/container/container_fwd.hpp>
+#endif
 
 namespace sdbus
 {
 
 static errc read(sd_bus_message* msg, auto& v)
 {
-    defctx ctx(msg);
+    context<error_policy::fail_fast> ctx(msg);
+    return read(ctx, v);
+}
+
+/*
+ * Reads into an existing object reusing its elements and their storage:
+ * sequences are overwritten in place and trimmed, node-based containers
+ * recycle their nodes, Dict structs keep properties absent from the message.
+ */
+static errc read_reuse(sd_bus_message* msg, auto& v)
+{
+    context<error_policy::fail_fast> ctx(msg);
+    ctx.set_reuse(true);
     return read(ctx, v);
 }
 
@@ -25,11 +48,256 @@ static errc read(subctx& ctx, auto&& v)
     return traits<type>::read_value(ctx, v);
 }
 
+template <typename... Ts>
+static errc read_all(sd_bus_message* msg, Ts&... v)
+{
+    context<error_policy::fail_fast> ctx(msg);
+    return read_all(ctx, v...);
+}
+
+/*
+ * Reads a whole message argument list after checking the message signature
+ * once against the expected one: the leading run of basic values comes out
+ * of one sd_bus_message_read() call, the rest is read one by one.
+ */
+template <typename... Ts>
+static errc read_all(subctx& ctx, Ts&... v)
+{
+    using args = arg_list<Ts...>;
+
+    if (sd_bus_message_has_signature(ctx.msg(), args::sig) <= 0)
+    {
+        return errc::invalid_type;
+    }
+
+    auto refs = std::tie(v...);
+    auto read_args = [&]<size_t... Is, size_t... Js>(std::index_sequence<Is...>,
+                                                   std::index_sequence<Js...>) {
+        auto ec = errc::success;
+        if constexpr (sizeof...(Is) > 0)
+        {
+            // sd-bus reads booleans as int
+            std::tuple<std::conditional_t<std::same_as<typename args::template type<Is>, bool>,
+                                          int, typename args::template type<Is>>...>
+                tmp;
+            ec = sdbus_errc(sd_bus_message_read(ctx.msg(), args::basic_sig, &std::get<Is>(tmp)...));
+            if (no_error(ec))
+            {
+                ((std::get<Is>(refs) =
+                      static_cast<typename args::template type<Is>>(std::get<Is>(tmp))),
+                 ...);
+            }
+        }
+        (void)(no_error(ec) && ... && no_error(ec = read(ctx, std::get<args::basic_size + Js>(refs))));
+        return ec;
+    };
+
+    return read_args(std::make_index_sequence<args::basic_size>{},
+                     std::make_index_sequence<sizeof...(Ts) - args::basic_size>{});
+}
+
+/*
+ * Steps over the next `count` complete values without decoding them. Running
+ * out of values is an error.
+ */
+static errc skip(subctx& ctx, size_t count = 1)
+{
+    while (count--)
+    {
+        if (sd_bus_message_skip(ctx.msg(), nullptr) <= 0)
+        {
+            return errc::read_error;
+        }
+    }
+    return errc::success;
+}
+
+/*
+ * Steps over the values left in the current container. sd-bus only exits a
+ * container once its read position is at the end.
+ */
+static void skip_rest(sd_bus_message* msg)
+{
+    while (sd_bus_message_at_end(msg, 0) == 0 && sd_bus_message_skip(msg, nullptr) > 0)
+    {}
+}
+
+/*
+ * Reads the message argument at `index`, counted from the first argument
+ * whatever has been read already.
+ */
+static errc read_arg(sd_bus_message* msg, size_t index, auto&& v)
+{
+    if (sd_bus_message_rewind(msg, 1) < 0)
+    {
+        return errc::read_error;
+    }
+
+    context<error_policy::fail_fast> ctx(msg);
+    auto ec = skip(ctx, index);
+    if (no_error(ec) && sd_bus_message_at_end(msg, 0) != 0)
+    {
+        ec = errc::read_error;
+    }
+    if (no_error(ec))
+    {
+        ec = read(ctx, v);
+    }
+    return ec;
+}
+
 struct reader_base
 {
     virtual errc read_value(subctx&) = 0;
 };
 
+template <typename R>
+static constexpr errc invoke_reader(subctx& ctx, R& rdr)
+{
+    if constexpr (std::is_abstract_v<R>)
+    {
+        return rdr.read_value(ctx);
+    }
+    else
+    {
+        return rdr.R::read_value(ctx);
+    }
+}
+
+template <typename Policy, typename R>
+static errc read_element(subctx& ctx, R& rdr)
+{
+    auto ec = invoke_reader(ctx, rdr);
+    if constexpr (Policy::on_error == element_policy::handle)
+    {
+        if (is_error(ec))
+        {
+            ec = ctx.error(ec);
+            if (no_error(ec))
+            {
+                sd_bus_message_skip(ctx.msg(), nullptr);
+            }
+        }
+    }
+    return ec;
+}
+
+template <typename Policy, typename R>
+static errc read_elements(subctx& ctx, R& rdr)
+{
+    auto msg = ctx.msg();
+    size_t index = 0;
+
+    for (;;)
+    {
+        auto ret = sd_bus_message_at_end(msg, 0);
+        if (ret < 0)
+        {
+            return errc::read_error;
+        }
+        if (ret > 0)
+        {
+            return errc::success;
+        }
+
+        errc ec;
+        if constexpr (Policy::track_path)
+        {
+            subctx ictx(index++, ctx);
+            ec = read_element<Policy>(ictx, rdr);
+        }
+        else
+        {
+            ec = read_element<Policy>(ctx, rdr);
+        }
+        if (is_error(ec))
+        {
+            return ec;
+        }
+    }
+}
+
+template <typename R>
+static errc read_array_inline(subctx& ctx, R& rdr)
+{
+    auto msg = ctx.msg();
+    auto ec = sdbus_errc(sd_bus_message_enter_container(msg, SD_BUS_TYPE_ARRAY, nullptr));
+    if (no_error(ec))
+    {
+        ec = ctx.with_policy(
+            [&]<typename Policy>(Policy) { return read_elements<Policy>(ctx, rdr); });
+        if (is_error(ec))
+        {
+            skip_rest(msg);
+        }
+        if (sd_bus_message_exit_container(msg) < 0)
+        {
+            return errc::read_error;
+        }
+    }
+
+    return ec;
+}
+
+template <typename R>
+static errc read_variant_inline(subctx& ctx, R& rdr)
+{
+    auto msg = ctx.msg();
+    auto ec = sdbus_errc(sd_bus_message_enter_container(msg, SD_BUS_TYPE_VARIANT, nullptr));
+    if (no_error(ec))
+    {
+        ec = invoke_reader(ctx, rdr);
+        if (is_error(ec))
+        {
+            sd_bus_message_skip(msg, nullptr);
+        }
+        if (sd_bus_message_exit_container(msg) < 0)
+        {
+            return errc::read_error;
+        }
+    }
+
+    return ec;
+}
+
+template <typename R>
+static errc read_dict_entry_inline(subctx& ctx, R& rdr)
+{
+    auto msg = ctx.msg();
+    auto ec = sdbus_errc(sd_bus_message_enter_container(msg, SD_BUS_TYPE_DICT_ENTRY, nullptr));
+    if (no_error(ec))
+    {
+        ec = invoke_reader(ctx, rdr);
+        if (ec == errc::unknown_property)
+        {
+            ec = errc::success;
+        }
+        if (sd_bus_message_exit_container(msg) < 0)
+        {
+            return errc::read_error;
+        }
+    }
+
+    return ec;
+}
+
+template <typename R>
+static errc read_struct_inline(subctx& ctx, R& rdr)
+{
+    auto msg = ctx.msg();
+    auto ec = sdbus_errc(sd_bus_message_enter_container(msg, SD_BUS_TYPE_STRUCT, nullptr));
+    if (no_error(ec))
+    {
+        ec = invoke_reader(ctx, rdr);
+        if (sd_bus_message_exit_container(msg) < 0)
+        {
+            return errc::read_error;
+        }
+    }
+
+    return ec;
+}
+
 template <typename T>
 errc read_string(subctx& ctx, T& v)
 {
@@ -72,63 +340,212 @@ struct variant_reader : simple_reader<T>
     using simple_reader<T>::simple_reader;
 };
 
+/*
+ * Creates a value to decode into. Allocator-aware (pmr) types are given the
+ * context's memory resource.
+ */
+template <typename T>
+static T make_value(const subctx& ctx)
+{
+    if constexpr (std::uses_allocator_v<T, std::pmr::polymorphic_allocator<>>)
+    {
+        return std::make_obj_using_allocator<T>(std::pmr::polymorphic_allocator<>(ctx.resource()));
+    }
+    else
+    {
+        return T{};
+    }
+}
+
+/*
+ * Empties a value that is about to be decoded again, keeping whatever
+ * storage it owns so that the next read can reuse it.
+ */
+template <typename T>
+static constexpr void reset_value(T& v)
+{
+    if constexpr (requires { v.clear(); })
+    {
+        v.clear();
+    }
+    else if constexpr (!concepts::Basic<T> && !concepts::Variant<T>)
+    {
+        v = T{};
+    }
+}
+
+/*
+ * Maps the signature of a variant's contents to the first alternative that
+ * carries it: basic signatures through a table indexed by the type code,
+ * compound ones through a perfect hash over the signature strings.
+ */
+template <typename T>
+struct variant_index;
+
+template <typename... Ts>
+struct variant_index<std::variant<Ts...>>
+{
+    static constexpr size_t npos = sizeof...(Ts);
+
+    static_assert(npos < 0xFF, "Too many variant alternatives.");
+
+    static constexpr size_t find(const char* sig) noexcept
+    {
+        if (sig == nullptr || sig[0] == 0)
+        {
+            return npos;
+        }
+
+        if (sig[1] == 0)
+        {
+            auto c = static_cast<uint8_t>(sig[0]);
+            return c < basic.size() ? basic[c] : npos;
+        }
+
+        auto i = compound.find(sig);
+        return i < compound_alts.size() ? compound_alts[i] : npos;
+    }
+
+  private:
+    static constexpr std::array<std::string_view, npos> sigs = {
+        std::string_view(traits<Ts>::sig)...};
+
+    static constexpr bool is_first(size_t i)
+    {
+        return std::find(sigs.begin(), sigs.begin() + i, sigs[i]) == sigs.begin() + i;
+    }
+
+    static constexpr size_t compound_count()
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < npos; ++i)
+        {
+            n += sigs[i].size() > 1 && is_first(i);
+        }
+        return n;
+    }
+
+    static constexpr auto make_basic()
+    {
+        std::array<uint8_t, 128> table;
+        table.fill(npos);
+        for (size_t i = 0; i < npos; ++i)
+        {
+            if (sigs[i].size() == 1 && is_first(i))
+            {
+                table[static_cast<uint8_t>(sigs[i][0]) & 0x7F] = i;
+            }
+        }
+        return table;
+    }
+
+    static constexpr auto make_compound_alts()
+    {
+        std::array<uint8_t, compound_count()> alts{};
+        for (size_t i = 0, n = 0; i < npos; ++i)
+        {
+            if (sigs[i].size() > 1 && is_first(i))
+            {
+                alts[n++] = i;
+            }
+        }
+        return alts;
+    }
+
+    static constexpr auto make_compound()
+    {
+        std::array<std::string_view, compound_alts.size()> keys;
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            keys[i] = sigs[compound_alts[i]];
+        }
+        return perfect_hash<keys.size()>(keys);
+    }
+
+    static constexpr auto basic = make_basic();
+    static constexpr auto compound_alts = make_compound_alts();
+    static constexpr auto compound = make_compound();
+};
+
 struct variant_reader_base : reader_base
 {
-    using callback_t = bool (variant_reader_base::*)(subctx&, const char*, errc&);
+    using callback_t = errc (variant_reader_base::*)(subctx&);
     using callbacks_t = std::span<const callback_t>;
+    using index_t = size_t (*)(const char*) noexcept;
 
-    variant_reader_base(const callbacks_t& callbacks) : _callbacks(callbacks)
+    variant_reader_base(const callbacks_t& callbacks, index_t index) :
+        _callbacks(callbacks), _index(index)
     {}
 
     errc read_value(subctx& ctx) override;
 
   private:
-    const callbacks_t& _callbacks;
+    callbacks_t _callbacks;
+    index_t _index;
 };
 
 template <concepts::Variant T>
 struct variant_reader<T> : variant_reader_base
 {
-    template <typename V>
-    bool read_one(subctx& ctx, const char* sig, errc& ec)
+    errc read_value(subctx& ctx) override
     {
-        if (sig != traits<V>::sig)
+        if constexpr (inline_codec)
         {
-            return false;
+            auto i = variant_index<T>::find(sd_bus_message_get_signature(ctx.msg(), 0));
+            return callbacks::read(*this, ctx, i);
         }
+        else
+        {
+            return variant_reader_base::read_value(ctx);
+        }
+    }
 
-        T v;
-
-        ec = read(ctx, v);
-        if (no_error(ec))
+    template <size_t I>
+    errc read_one(subctx& ctx)
+    {
+        try
         {
-            try
-            {
-                _v = std::move(v);
-            }
-            catch (std::bad_alloc&)
+            if (_v.index() != I)
             {
-                ec = errc::no_memory;
+                _v.template emplace<I>(make_value<std::variant_alternative_t<I, T>>(ctx));
             }
-            catch (...)
+            else if (!ctx.reuse())
             {
-                ec = errc::bad_exception;
+                reset_value(std::get<I>(_v));
             }
         }
+        catch (std::bad_alloc&)
+        {
+            return errc::no_memory;
+        }
+        catch (...)
+        {
+            return errc::bad_exception;
+        }
 
-        return true;
+        return read(ctx, std::get<I>(_v));
     }
 
-    template <typename F>
+    template <typename S>
     struct callbacks_holder;
 
-    template <typename... Ts>
-    struct callbacks_holder<std::variant<Ts...>>
+    template <size_t... Is>
+    struct callbacks_holder<std::index_sequence<Is...>>
     {
-        static constexpr auto cb = {static_cast<callback_t>(&variant_reader<T>::read_one<Ts>)...};
+        static constexpr callback_t cb[] = {
+            static_cast<callback_t>(&variant_reader<T>::read_one<Is>)...};
+
+        static errc read(variant_reader& rdr, subctx& ctx, size_t index)
+        {
+            errc ec = errc::bad_variant;
+            ((index == Is && (ec = rdr.template read_one<Is>(ctx), true)) || ...);
+            return ec;
+        }
     };
 
-    variant_reader(T& v) : variant_reader_base(callbacks_holder<T>::cb), _v(v)
+    using callbacks = callbacks_holder<std::make_index_sequence<std::variant_size_v<T>>>;
+
+    variant_reader(T& v) : variant_reader_base(callbacks::cb, &variant_index<T>::find), _v(v)
     {}
 
   private:
@@ -139,7 +556,14 @@ template <typename T>
 errc read_variant(subctx& ctx, T& v)
 {
     auto rdr = variant_reader<T>(v);
-    return read_variant_impl(ctx, rdr);
+    if constexpr (inline_codec)
+    {
+        return read_variant_inline(ctx, rdr);
+    }
+    else
+    {
+        return read_variant_impl(ctx, rdr);
+    }
 }
 
 template <typename T>
@@ -169,7 +593,49 @@ template <typename T>
 errc read_dict_entry(subctx& ctx, T& v)
 {
     auto r = dict_entry_reader<T>(v);
-    return read_dict_entry_impl(ctx, r);
+    if constexpr (inline_codec)
+    {
+        return read_dict_entry_inline(ctx, r);
+    }
+    else
+    {
+        return read_dict_entry_impl(ctx, r);
+    }
+}
+
+template <typename T>
+struct struct_reader : reader_base
+{
+    constexpr struct_reader(T& v) : _v{v}
+    {}
+
+    errc read_value(subctx& ctx) override
+    {
+        return std::apply(
+            [&](auto&... fields) {
+                auto ec = errc::success;
+                (void)(no_error(ec = read(ctx, fields)) && ...);
+                return ec;
+            },
+            traits<T>::fields(_v));
+    }
+
+  private:
+    T& _v;
+};
+
+template <typename T>
+errc read_struct(subctx& ctx, T& v)
+{
+    auto r = struct_reader<T>(v);
+    if constexpr (inline_codec)
+    {
+        return read_struct_inline(ctx, r);
+    }
+    else
+    {
+        return read_struct_impl(ctx, r);
+    }
 }
 
 template <typename T>
@@ -199,30 +665,43 @@ struct container_reader : reader_base
 
     errc read_value(subctx& ctx) override
     {
-        if (ctx.index() == _container.size())
+        if (_index == _container.size())
         {
             return errc::out_of_space;
         }
-        auto& v = _container[ctx.index()];
-        return traits<value_type>::read_value(ctx, v);
+        auto& v = _container[_index++];
+        return element_traits<value_type>::read_value(ctx, v);
     }
 
   private:
     T& _container;
+    size_t _index = 0;
 };
 
 template <concepts::Emplaceable T, typename V>
 struct container_reader<T, V> : reader_base
 {
-    using value_type = typename value_type_traits<V>::type;
+    using value_type = typename value_type_traits<typename T::value_type>::type;
+    using item_type = typename value_type_traits<V>::type;
 
-    container_reader(T& container) : _container(container)
+    container_reader(T& container, bool prescan = false) : _container(container), _prescan(prescan)
     {}
 
     errc read_value(subctx& ctx) override
     {
-        value_type _value;
-        auto ec = traits<value_type>::read_value(ctx, _value);
+        auto ec = reserve(ctx, _container.size());
+        if (is_error(ec))
+        {
+            return ec;
+        }
+        return emplace(ctx);
+    }
+
+  protected:
+    errc emplace(subctx& ctx)
+    {
+        auto _value = make_item();
+        auto ec = element_traits<item_type>::read_value(ctx, _value);
         if (no_error(ec))
         {
             try
@@ -248,8 +727,59 @@ struct container_reader<T, V> : reader_base
         return ec;
     }
 
+    /*
+     * Elements are built with the container's allocator so that moving them
+     * in does not copy.
+     */
+    value_type make_item() const
+    {
+        if constexpr (requires { _container.get_allocator(); })
+        {
+            return std::make_obj_using_allocator<value_type>(_container.get_allocator());
+        }
+        else
+        {
+            return value_type{};
+        }
+    }
+
+    /*
+     * With a pre-scan, sizes the container for the whole array on top of its
+     * first `keep` elements before the first item is read; the items are
+     * counted by skipping over them and rewinding.
+     */
+    errc reserve(subctx& ctx, size_t keep)
+    {
+        if constexpr (concepts::Reservable<T>)
+        {
+            if (_prescan)
+            {
+                _prescan = false;
+
+                size_t size;
+                auto ec = read_array_size_impl(ctx, &size);
+                if (is_error(ec))
+                {
+                    return ec;
+                }
+
+                try
+                {
+                    _container.reserve(keep + size);
+                }
+                catch (std::bad_alloc&)
+                {
+                    return errc::no_memory;
+                }
+            }
+        }
+
+        return errc::success;
+    }
+
   private:
     T& _container;
+    bool _prescan;
 };
 
 template <concepts::Container T>
@@ -265,12 +795,185 @@ struct item_reader<array_of_helper<C, V>> : container_reader<C, V>
     {}
 };
 
+template <typename C>
+struct item_reader<presized_helper<C>> : container_reader<C>
+{
+    constexpr item_reader(presized_helper<C>& v) : container_reader<C>(v.ref, true)
+    {}
+};
+
+template <typename T, typename V = typename T::value_type>
+struct container_reuse_reader : container_reader<T, V>
+{
+    container_reuse_reader(T& container, bool prescan = false) :
+        container_reader<T, V>(container, prescan)
+    {
+        container.clear();
+    }
+
+    constexpr void trim()
+    {}
+};
+
+template <concepts::Sequence T, typename V>
+struct container_reuse_reader<T, V> : container_reader<T, V>
+{
+    using item_type = typename container_reader<T, V>::item_type;
+
+    container_reuse_reader(T& container, bool prescan = false) :
+        container_reader<T, V>(container, prescan), _container(container)
+    {}
+
+    errc read_value(subctx& ctx) override
+    {
+        auto ec = this->reserve(ctx, 0);
+        if (is_error(ec))
+        {
+            return ec;
+        }
+
+        ec = _used < _container.size()
+                 ? element_traits<item_type>::read_value(ctx, _container[_used])
+                 : this->emplace(ctx);
+        _used += no_error(ec);
+        return ec;
+    }
+
+    void trim()
+    {
+        _container.resize(_used);
+    }
+
+  private:
+    T& _container;
+    size_t _used = 0;
+};
+
+template <concepts::NodeContainer T, typename V>
+struct container_reuse_reader<T, V> : container_reader<T, V>
+{
+    container_reuse_reader(T& container, bool prescan = false) :
+        container_reader<T, V>(container, prescan), _container(container),
+        _pool(container.get_allocator())
+    {
+        _pool.swap(container);
+    }
+
+    errc read_value(subctx& ctx) override
+    {
+        if (_pool.empty())
+        {
+            return container_reader<T, V>::read_value(ctx);
+        }
+
+        auto node = _pool.extract(_pool.begin());
+        errc ec;
+        if constexpr (requires { node.mapped(); })
+        {
+            auto entry = std::pair<typename T::key_type&, typename T::mapped_type&>(node.key(),
+                                                                                  node.mapped());
+            ec = read_dict_entry(ctx, entry);
+        }
+        else
+        {
+            ec = element_traits<typename T::value_type>::read_value(ctx, node.value());
+        }
+
+        if (no_error(ec))
+        {
+            try
+            {
+                _container.insert(std::move(node));
+            }
+            catch (std::bad_alloc&)
+            {
+                ec = errc::no_memory;
+            }
+            catch (...)
+            {
+                ec = errc::bad_exception;
+            }
+        }
+        return ec;
+    }
+
+    constexpr void trim()
+    {}
+
+  private:
+    T& _container;
+    T _pool;
+};
+
+template <typename T>
+struct item_reuse_reader : container_reuse_reader<T>
+{
+    using container_reuse_reader<T>::container_reuse_reader;
+};
+
+template <typename C, typename V>
+struct item_reuse_reader<array_of_helper<C, V>> : container_reuse_reader<C, V>
+{
+    constexpr item_reuse_reader(array_of_helper<C, V>& v) : container_reuse_reader<C, V>(v.ref)
+    {}
+};
+
+template <typename C>
+struct item_reuse_reader<presized_helper<C>> : container_reuse_reader<C>
+{
+    constexpr item_reuse_reader(presized_helper<C>& v) : container_reuse_reader<C>(v.ref, true)
+    {}
+};
+
+template <typename T>
+static constexpr bool reusable = concepts::Emplaceable<T>;
+
+template <typename C, typename V>
+static constexpr bool reusable<array_of_helper<C, V>> = concepts::Emplaceable<C>;
+
+template <typename C>
+static constexpr bool reusable<presized_helper<C>> = concepts::Emplaceable<C>;
+
 struct dict_reader_base : reader_base
 {
     errc read_value(subctx& ctx) override;
 
-  protected:
     virtual errc read_entry(subctx& ctx, const char*) = 0;
+
+  protected:
+    template <typename R>
+    static errc read_item(subctx& ctx, R& rdr)
+    {
+        auto msg = ctx.msg();
+        auto ec = sdbus_errc(sd_bus_message_enter_container(msg, SD_BUS_TYPE_DICT_ENTRY, nullptr));
+        if (no_error(ec))
+        {
+            const char* name;
+            ec = read(ctx, name);
+            if (no_error(ec))
+            {
+                if constexpr (std::is_abstract_v<R>)
+                {
+                    ec = rdr.read_entry(ctx, name);
+                }
+                else
+                {
+                    ec = rdr.R::read_entry(ctx, name);
+                }
+            }
+            if (ec == errc::unknown_property)
+            {
+                sd_bus_message_skip(msg, 0);
+                ec = errc::success;
+            }
+            if (sd_bus_message_exit_container(msg) < 0)
+            {
+                return errc::read_error;
+            }
+        }
+
+        return ec;
+    }
 };
 
 template <typename T>
@@ -279,28 +982,29 @@ struct dict_reader : dict_reader_base
     dict_reader(T& v) : _compound(v)
     {}
 
-  protected:
-    errc read_entry(subctx& ctx, const char* name)
+    errc read_value(subctx& ctx) override
     {
-        auto _descs = make_descs();
-        auto iter = std::ranges::find_if(
-            _descs, [&](const auto& item) -> bool { return item.name() == name; });
-
-        if (iter == _descs.end())
+        if constexpr (inline_codec)
         {
-            return errc::unknown_property;
+            return read_item(ctx, *this);
+        }
+        else
+        {
+            return dict_reader_base::read_value(ctx);
         }
-        return iter->read_value(ctx, _compound);
     }
 
-  private:
-    static constexpr auto make_descs()
+    errc read_entry(subctx& ctx, const char* name) override
     {
-        using props = typename T::dict_t;
-        return property_desc_maker<props>::make_descs();
+        auto desc = property_table<T>::find(name);
+        if (desc == nullptr)
+        {
+            return errc::unknown_property;
+        }
+        return desc->read_value(ctx, _compound);
     }
 
-  private:
+  protected:
     T& _compound;
 };
 
@@ -310,11 +1014,275 @@ struct item_reader<T> : dict_reader<T>
     using dict_reader<T>::dict_reader;
 };
 
+template <typename T>
+struct item_reader<projection<T>> : dict_reader<T>
+{
+    item_reader(projection<T>& v) : dict_reader<T>(v.ref), _mask(v.mask)
+    {}
+
+    errc read_value(subctx& ctx) override
+    {
+        if constexpr (inline_codec)
+        {
+            return this->read_item(ctx, *this);
+        }
+        else
+        {
+            return dict_reader_base::read_value(ctx);
+        }
+    }
+
+    errc read_entry(subctx& ctx, const char* name) override
+    {
+        auto desc = property_table<T>::find(name);
+        if (desc == nullptr || !_mask.test(property_table<T>::index_of(desc)))
+        {
+            return errc::unknown_property;
+        }
+        return desc->read_value(ctx, this->_compound);
+    }
+
+  private:
+    const property_mask<T>& _mask;
+};
+
+template <typename R>
+static errc read_items(subctx& ctx, R& rdr)
+{
+    if constexpr (inline_codec)
+    {
+        return read_array_inline(ctx, rdr);
+    }
+    else
+    {
+        return read_array_impl(ctx, rdr);
+    }
+}
+
+/*
+ * Orders freshly appended elements of a flat container: the sort is skipped
+ * for input that is already sorted and, as with emplace(), the first of
+ * equal keys is kept.
+ */
+template <typename T, typename S, typename C>
+static void sort_flat(S& seq, C comp)
+{
+    if (!std::is_sorted(seq.begin(), seq.end(), comp))
+    {
+        std::stable_sort(seq.begin(), seq.end(), comp);
+    }
+    if constexpr (concepts::UniqueKeys<T>)
+    {
+        auto equal = [&](const auto& a, const auto& b) { return !comp(a, b); };
+        seq.erase(std::unique(seq.begin(), seq.end(), equal), seq.end());
+    }
+}
+
+/*
+ * Flat containers are read through their underlying storage and sorted once
+ * at the end, per-element inserts would shift the tail each time.
+ */
+template <concepts::FlatContainer T>
+static errc read_flat(subctx& ctx, T& v)
+{
+    if constexpr (concepts::BoostFlat<T>)
+    {
+        auto seq = v.extract_sequence();
+        auto ec = read_array(ctx, seq);
+        sort_flat<T>(seq, v.value_comp());
+        if constexpr (concepts::UniqueKeys<T>)
+        {
+            v.adopt_sequence(boost::container::ordered_unique_range, std::move(seq));
+        }
+        else
+        {
+            v.adopt_sequence(boost::container::ordered_range, std::move(seq));
+        }
+        return ec;
+    }
+    else
+    {
+        using key_type = typename T::key_type;
+        using mapped_type = typename T::mapped_type;
+
+        auto c = std::move(v).extract();
+
+        // The sequence shares the keys' allocator, so a pmr resource carries over.
+        using item_type = std::pair<key_type, mapped_type>;
+        using key_alloc = decltype(c.keys.get_allocator());
+        using alloc_type = std::allocator_traits<key_alloc>::template rebind_alloc<item_type>;
+
+        std::vector<item_type, alloc_type> seq(c.keys.get_allocator());
+        seq.reserve(c.keys.size());
+        for (size_t i = 0; i < c.keys.size(); ++i)
+        {
+            seq.emplace_back(std::move(c.keys[i]), std::move(c.values[i]));
+        }
+        auto ec = read_array(ctx, seq);
+        sort_flat<T>(seq, v.value_comp());
+
+        c.keys.clear();
+        c.values.clear();
+        for (auto& [key, value] : seq)
+        {
+            c.keys.push_back(std::move(key));
+            c.values.push_back(std::move(value));
+        }
+        v.replace(std::move(c.keys), std::move(c.values));
+        return ec;
+    }
+}
+
+/*
+ * Containers of fixed-size elements are filled from one
+ * sd_bus_message_read_array() call, sized once from the byte length.
+ */
+template <typename T>
+static errc read_fixed_items(subctx& ctx, T& v)
+{
+    using value_type = typename T::value_type;
+
+    if constexpr (concepts::Resizable<T>)
+    {
+        return read_converted_array<value_type>(ctx, v);
+    }
+    else
+    {
+        const void* data;
+        size_t size;
+        auto ec = read_basic_array_impl(ctx, traits<value_type>::sig, &data, &size);
+        if (is_error(ec))
+        {
+            return ec;
+        }
+
+        auto first = static_cast<const value_type*>(data);
+        auto last = first + size / sizeof(value_type);
+        try
+        {
+            if (ctx.reuse())
+            {
+                v.clear();
+            }
+            if constexpr (concepts::Reservable<T>)
+            {
+                v.reserve(v.size() + (last - first));
+            }
+            if constexpr (concepts::HasEmplace<T>)
+            {
+                v.insert(first, last);
+            }
+            else
+            {
+                v.insert(v.end(), first, last);
+            }
+        }
+        catch (std::bad_alloc&)
+        {
+            return errc::no_memory;
+        }
+        return errc::success;
+    }
+}
+
 template <typename T>
 static errc read_array(subctx& ctx, T& v)
 {
+    if constexpr (concepts::FlatContainer<T>)
+    {
+        return read_flat(ctx, v);
+    }
+
+    if constexpr (concepts::FixedContainer<T>)
+    {
+        // Reused node containers keep their nodes instead.
+        if (!concepts::NodeContainer<T> || !ctx.reuse())
+        {
+            return read_fixed_items(ctx, v);
+        }
+    }
+
+    if constexpr (reusable<T>)
+    {
+        if (ctx.reuse())
+        {
+            item_reuse_reader<T> r(v);
+            auto ec = read_items(ctx, r);
+            r.trim();
+            return ec;
+        }
+    }
+
     item_reader<T> r(v);
-    return read_array_impl(ctx, r);
+    return read_items(ctx, r);
+}
+
+/*
+ * Reads an array of basic type S in one sd_bus_message_read_array() call
+ * and converts it into a container of another (or the same) basic type.
+ */
+template <typename S, typename T>
+static errc read_converted_array(subctx& ctx, T& v)
+{
+    using wire_type = wire_type_t<S>;
+
+    const void* data;
+    size_t size;
+    auto ec = read_basic_array_impl(ctx, traits<S>::sig, &data, &size);
+    if (is_error(ec))
+    {
+        return ec;
+    }
+
+    size_t count = size / sizeof(wire_type);
+    size_t offset = 0;
+
+    if constexpr (concepts::Resizable<T>)
+    {
+        offset = ctx.reuse() ? 0 : v.size();
+        try
+        {
+            v.resize(offset + count);
+        }
+        catch (std::bad_alloc&)
+        {
+            return errc::no_memory;
+        }
+    }
+    else if (count > v.size())
+    {
+        subctx ictx(v.size(), ctx);
+        ec = ictx.error(errc::out_of_space);
+        if (is_error(ec))
+        {
+            return ec;
+        }
+        count = v.size();
+    }
+
+    convert_elements(static_cast<const wire_type*>(data), count, std::next(v.begin(), offset));
+    return errc::success;
+}
+
+template <typename T>
+static errc read_basic_array(subctx& ctx, T& v)
+{
+    return read_converted_array<typename T::value_type>(ctx, v);
+}
+
+template <typename T>
+static errc read_basic_view(subctx& ctx, T& v)
+{
+    using value_type = typename T::value_type;
+
+    const void* data;
+    size_t size;
+    auto ec = read_basic_array_impl(ctx, traits<value_type>::sig, &data, &size);
+    if (no_error(ec))
+    {
+        v = T(static_cast<const value_type*>(data), size / sizeof(value_type));
+    }
+    return ec;
 }
 } // namespace sdbus
 
@@ -569,6 +569,13 @@ class bus
         return m1;
     }
 
+    /// Create a message from a prepared_call or prepared_signal.
+    template <typename Prepared, typename... Args>
+    message new_message(const Args&... args)
+    {
+        return Prepared::create(_impl.get_implementation().state->get_bus(), args...);
+    }
+
   private:
     /// Construct a bus object bound to sd_bus pointer.
     explicit bus(const executor_type& ex, sd_bus* b) : _impl(0, ex)
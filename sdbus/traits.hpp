@@ -3,6 +3,10 @@
 
 #include <sdbus/concepts.hpp>
 #include <sdbus/helpers.hpp>
+#include <sdbus/perfect_hash.hpp>
+
+#include <functional>
+#include <utility>
 
 namespace sdbus
 {
@@ -85,12 +89,146 @@ struct default_basic_traits
         basic_write_helper wh(std::forward<F>(v));
         return write_basic(ctx, wh.ref());
     }
+
+    static errc encode_value(wire::encoder& e, const T& v)
+    {
+        return wire::encode_basic(e, v);
+    }
+
+    static errc decode_value(wire::decoder& d, T& v)
+    {
+        return wire::decode_basic(d, v);
+    }
 };
 
 template <concepts::Basic T>
 struct default_traits<T> : default_basic_traits<T>
 {};
 
+template <typename T>
+struct default_enum_traits
+{
+    using underlying_type = std::underlying_type_t<T>;
+
+    static constexpr auto sig = basic_signature<underlying_type>();
+
+    static errc read_value(subctx& ctx, T& v)
+    {
+        underlying_type tmp;
+        auto ec = read_basic(ctx, tmp);
+        if (no_error(ec))
+        {
+            v = static_cast<T>(tmp);
+        }
+        return ec;
+    }
+
+    static errc write_value(subctx& ctx, const T& v)
+    {
+        return write_basic(ctx, std::to_underlying(v));
+    }
+
+    static errc encode_value(wire::encoder& e, const T& v)
+    {
+        return wire::encode_basic(e, std::to_underlying(v));
+    }
+
+    static errc decode_value(wire::decoder& d, T& v)
+    {
+        underlying_type tmp;
+        auto ec = wire::decode_basic(d, tmp);
+        if (no_error(ec))
+        {
+            v = static_cast<T>(tmp);
+        }
+        return ec;
+    }
+};
+
+template <concepts::Enum T>
+struct default_traits<T> : default_enum_traits<T>
+{};
+
+/*
+ * Encodes a scoped enum as a string, Names giving the strings of the
+ * enumerators 0, 1, 2, ... in order. Strings are decoded through a
+ * compile-time perfect hash and encoded by indexing the table. Enabled per
+ * enum by specializing traits:
+ *
+ *   template <>
+ *   struct traits<state> : enum_string_traits<state, "Running", "Degraded"> {};
+ */
+template <concepts::Enum T, sig_string... Names>
+struct enum_string_traits
+{
+    static constexpr auto sig = sig_string("s");
+
+    static constexpr std::array<const char*, sizeof...(Names)> names = {Names.c_str()...};
+
+    // Returns the enumerator index of a string, or names.size() if unknown.
+    static constexpr size_t find(std::string_view str) noexcept
+    {
+        return index.find(str);
+    }
+
+    static errc read_value(subctx& ctx, T& v)
+    {
+        const char* str;
+        auto ec = read_basic_impl(ctx, sig, &str);
+        if (no_error(ec))
+        {
+            auto i = find(str);
+            if (i == names.size())
+            {
+                return errc::invalid_enum_string;
+            }
+            v = static_cast<T>(i);
+        }
+        return ec;
+    }
+
+    static errc write_value(subctx& ctx, const T& v)
+    {
+        auto i = static_cast<size_t>(std::to_underlying(v));
+        if (i >= names.size())
+        {
+            return errc::invalid_enum;
+        }
+        return write_basic_impl(ctx, sig, names[i]);
+    }
+
+    static errc encode_value(wire::encoder& e, const T& v)
+    {
+        auto i = static_cast<size_t>(std::to_underlying(v));
+        if (i >= names.size())
+        {
+            return errc::invalid_enum;
+        }
+        return wire::encode_string(e, std::string_view(names[i]));
+    }
+
+    static errc decode_value(wire::decoder& d, T& v)
+    {
+        std::string_view str;
+        auto ec = wire::decode_string(d, str);
+        if (no_error(ec))
+        {
+            auto i = find(str);
+            if (i == names.size())
+            {
+                return errc::invalid_enum_string;
+            }
+            v = static_cast<T>(i);
+        }
+        return ec;
+    }
+
+  private:
+    static constexpr auto index = perfect_hash<sizeof...(Names)>({Names.sv()...});
+
+    static_assert(index.valid(), "Enum strings must be unique.");
+};
+
 template <typename T>
 consteval auto string_signature()
 {
@@ -113,6 +251,16 @@ struct default_string_traits
     {
         return write_string(ctx, std::forward<F>(v));
     }
+
+    static errc encode_value(wire::encoder& e, const T& v)
+    {
+        return wire::encode_string(e, v);
+    }
+
+    static errc decode_value(wire::decoder& d, T& v)
+    {
+        return wire::decode_string(d, v);
+    }
 };
 
 template <concepts::String T>
@@ -134,12 +282,73 @@ struct default_write_only_string_traits : default_string_traits<T>
         static_assert(false, "Can't read write-only string.");
         return errc::read_error;
     }
+
+    static errc decode_value(wire::decoder&, T&)
+    {
+        static_assert(false, "Can't read write-only string.");
+        return errc::read_error;
+    }
 };
 
 template <concepts::WriteOnlyString T>
 struct default_traits<T> : default_write_only_string_traits<T>
 {};
 
+template <typename F>
+struct default_traits<string_emplace_helper<F>>
+{
+    static constexpr auto sig = sig_string("s");
+
+    static errc read_value(subctx&, string_emplace_helper<F>&)
+    {
+        static_assert(false, "Can't read emplaced string.");
+        return errc::read_error;
+    }
+
+    static errc write_value(subctx& ctx, const string_emplace_helper<F>& v)
+    {
+        char* buf;
+        auto ec = write_string_space_impl(ctx, v.size, &buf);
+        if (no_error(ec))
+        {
+            v.fill(std::span<char>(buf, v.size));
+        }
+        return ec;
+    }
+};
+
+template <size_t N>
+struct default_traits<concat_helper<N>>
+{
+    static constexpr auto sig = sig_string("s");
+
+    static errc read_value(subctx&, concat_helper<N>&)
+    {
+        static_assert(false, "Can't read concatenated string.");
+        return errc::read_error;
+    }
+
+    static errc write_value(subctx& ctx, const concat_helper<N>& v)
+    {
+        size_t size = 0;
+        for (auto part : v.parts)
+        {
+            size += part.size();
+        }
+
+        char* buf;
+        auto ec = write_string_space_impl(ctx, size, &buf);
+        if (no_error(ec))
+        {
+            for (auto part : v.parts)
+            {
+                buf += part.copy(buf, part.size());
+            }
+        }
+        return ec;
+    }
+};
+
 template <typename T>
 struct default_variant_traits
 {
@@ -156,6 +365,16 @@ struct default_variant_traits
     {
         return write_variant(ctx, std::forward<F>(v));
     }
+
+    static errc encode_value(wire::encoder& e, const T& v)
+    {
+        return wire::encode_variant(e, v);
+    }
+
+    static errc decode_value(wire::decoder& d, T& v)
+    {
+        return wire::decode_variant(d, v);
+    }
 };
 
 template <concepts::Variant T>
@@ -165,7 +384,7 @@ struct default_traits<T> : default_variant_traits<T>
 template <typename T>
 struct default_array_traits
 {
-    static constexpr auto sig = "a" + traits<typename T::value_type>::sig;
+    static constexpr auto sig = "a" + element_traits<typename T::value_type>::sig;
 
     template <typename F>
     static errc read_value(subctx& ctx, F&& v)
@@ -180,15 +399,120 @@ struct default_array_traits
     }
 };
 
+template <concepts::BasicArray T>
+struct default_array_traits<T>
+{
+    static constexpr auto sig = "a" + traits<typename T::value_type>::sig;
+
+    template <typename F>
+    static errc read_value(subctx& ctx, F&& v)
+    {
+        return read_basic_array(ctx, std::forward<F>(v));
+    }
+
+    template <typename F>
+    static errc write_value(subctx& ctx, F&& v)
+    {
+        return write_basic_array(ctx, std::forward<F>(v));
+    }
+};
+
+template <concepts::BoolArray T>
+struct default_array_traits<T>
+{
+    static constexpr auto sig = sig_string("ab");
+
+    template <typename F>
+    static errc read_value(subctx& ctx, F&& v)
+    {
+        return read_converted_array<bool>(ctx, v);
+    }
+
+    template <typename F>
+    static errc write_value(subctx& ctx, F&& v)
+    {
+        return write_bool_array(ctx, v);
+    }
+};
+
+template <concepts::BasicView T>
+struct default_array_traits<T> : default_array_traits<std::span<typename T::value_type>>
+{
+    template <typename F>
+    static errc read_value(subctx& ctx, F&& v)
+    {
+        return read_basic_view(ctx, std::forward<F>(v));
+    }
+};
+
 template <concepts::Container T>
 struct default_traits<T> : default_array_traits<T>
-{};
+{
+    static errc encode_value(wire::encoder& e, const T& v)
+    {
+        return wire::encode_array(e, v);
+    }
+
+    static errc decode_value(wire::decoder& d, T& v)
+    {
+        return wire::decode_array(d, v);
+    }
+};
+
+template <concepts::InputRange T>
+struct default_traits<T>
+{
+    static constexpr auto sig = "a" + element_traits<std::ranges::range_value_t<T>>::sig;
+
+    static errc read_value(subctx&, T&)
+    {
+        static_assert(false, "Can't read into a range view.");
+        return errc::read_error;
+    }
+
+    static errc write_value(subctx& ctx, const T& v)
+    {
+        static_assert(!concepts::MutableRange<T>, "This range can only be written when non-const.");
+        return write_range(ctx, v);
+    }
+
+    static errc write_value(subctx& ctx, T& v)
+        requires concepts::MutableRange<T>
+    {
+        return write_range(ctx, v);
+    }
+};
+
+template <typename T, typename F>
+struct default_traits<array_emplace_helper<T, F>>
+{
+    static_assert(concepts::Fixed<T>, "Only fixed-size elements can be emplaced.");
+
+    static constexpr auto sig = "a" + traits<T>::sig;
+
+    static errc read_value(subctx&, array_emplace_helper<T, F>&)
+    {
+        static_assert(false, "Can't read emplaced array.");
+        return errc::read_error;
+    }
+
+    static errc write_value(subctx& ctx, const array_emplace_helper<T, F>& v)
+    {
+        void* buf;
+        auto ec = write_array_space_impl(ctx, traits<T>::sig, v.count * sizeof(T), &buf);
+        if (no_error(ec))
+        {
+            v.fill(std::span<T>(static_cast<T*>(buf), v.count));
+        }
+        return ec;
+    }
+};
 
 template <typename T>
 struct default_dict_entry_traits
 {
-    using first_type = typename T::first_type;
-    using second_type = typename T::second_type;
+    using first_type = std::remove_cv_t<typename T::first_type>;
+    using second_type = std::remove_cv_t<typename T::second_type>;
 
     static constexpr auto sig = "{" + traits<first_type>::sig + traits<second_type>::sig + "}";
 
@@ -201,10 +525,243 @@ struct default_dict_entry_traits
     {
         return write_dict_entry(ctx, v);
     }
+
+    static errc encode_value(wire::encoder& e, const T& v)
+    {
+        return wire::encode_dict_entry(e, v);
+    }
+
+    static errc decode_value(wire::decoder& d, T& v)
+    {
+        return wire::decode_dict_entry(d, v);
+    }
 };
 
 template <concepts::DictEntry T>
-struct default_traits<T> : default_dict_entry_traits<T>
+struct element_traits<T> : default_dict_entry_traits<T>
+{};
+
+template <typename M>
+struct member_pointer;
+
+template <typename C, typename F>
+struct member_pointer<F C::*>
+{
+    using class_type = C;
+    using type = F;
+};
+
+template <typename T, typename Tuple = T>
+struct default_tuple_traits;
+
+template <typename T, typename... Ts>
+struct default_tuple_traits<T, std::tuple<Ts...>>
+{
+    static_assert(sizeof...(Ts) > 0, "D-Bus structs can't be empty.");
+
+    static constexpr auto contents = (sig_string("") + ... + traits<std::remove_cv_t<Ts>>::sig);
+
+    static constexpr auto sig = "(" + contents + ")";
+
+    // The fields of a struct, in order, as a tuple-like object.
+    static constexpr T& fields(T& v)
+    {
+        return v;
+    }
+
+    static constexpr const T& fields(const T& v)
+    {
+        return v;
+    }
+
+    static errc read_value(subctx& ctx, T& v)
+    {
+        return read_struct(ctx, v);
+    }
+
+    static errc write_value(subctx& ctx, const T& v)
+    {
+        return write_struct(ctx, v);
+    }
+
+    static errc encode_value(wire::encoder& e, const T& v)
+    {
+        return wire::encode_struct(e, v);
+    }
+
+    static errc decode_value(wire::decoder& d, T& v)
+    {
+        return wire::decode_struct(d, v);
+    }
+};
+
+template <typename T1, typename T2>
+struct default_tuple_traits<std::pair<T1, T2>> :
+    default_tuple_traits<std::pair<T1, T2>, std::tuple<T1, T2>>
+{};
+
+template <concepts::Tuple T>
+struct default_traits<T> : default_tuple_traits<T>
+{};
+
+// Pair-like classes other than std::pair are structs of first and second.
+template <typename T>
+struct default_pair_traits
+{
+    using first_type = std::remove_cv_t<typename T::first_type>;
+    using second_type = std::remove_cv_t<typename T::second_type>;
+
+    static constexpr auto contents = traits<first_type>::sig + traits<second_type>::sig;
+
+    static constexpr auto sig = "(" + contents + ")";
+
+    static constexpr auto fields(T& v)
+    {
+        return std::tie(v.first, v.second);
+    }
+
+    static constexpr auto fields(const T& v)
+    {
+        return std::tie(v.first, v.second);
+    }
+
+    static errc read_value(subctx& ctx, T& v)
+    {
+        return read_struct(ctx, v);
+    }
+
+    static errc write_value(subctx& ctx, const T& v)
+    {
+        return write_struct(ctx, v);
+    }
+
+    static errc encode_value(wire::encoder& e, const T& v)
+    {
+        return wire::encode_struct(e, v);
+    }
+
+    static errc decode_value(wire::decoder& d, T& v)
+    {
+        return wire::decode_struct(d, v);
+    }
+};
+
+template <concepts::DictEntry T>
+    requires(!concepts::Tuple<T>)
+struct default_traits<T> : default_pair_traits<T>
+{};
+
+/*
+ * Encodes a class as a D-Bus struct of the listed data members, given in
+ * declaration order. Enabled per class by specializing traits:
+ *
+ *   template <>
+ *   struct traits<sample> : struct_traits<sample, &sample::time, &sample::min, &sample::max> {};
+ *
+ * or by declaring the member list in the class:
+ *
+ *   using struct_t = sdbus::members<&sample::time, &sample::min, &sample::max>;
+ *
+ * The class is layout compatible when its memory image is its little-endian
+ * wire form: trivially copyable, fixed-size members aligned to their size
+ * and no padding. Arrays of such structs are then copied in one piece by
+ * the wire codec.
+ */
+template <typename T, auto... Members>
+struct struct_traits
+{
+    static_assert((std::same_as<typename member_pointer<decltype(Members)>::class_type, T> && ...),
+                  "Struct members must be data members of the struct.");
+
+    template <auto M>
+    using member_type = typename member_pointer<decltype(M)>::type;
+
+    static constexpr auto contents = (sig_string("") + ... + traits<member_type<Members>>::sig);
+
+    static constexpr auto sig = "(" + contents + ")";
+
+    // Whether the listed members are distinct and in memory order.
+    static consteval bool in_memory_order()
+    {
+        T obj{};
+        const void* addrs[] = {static_cast<const void*>(&(obj.*Members))...};
+        for (size_t i = 1; i < sizeof...(Members); ++i)
+        {
+            if (!std::less<const void*>{}(addrs[i - 1], addrs[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /*
+     * Members in memory order whose sizes add up to the struct leave no room
+     * for padding, so their offsets are the running sums checked here.
+     */
+    static constexpr bool layout_compatible = [] {
+        size_t offset = 0;
+        bool packed = true;
+        auto place = [&]<typename F>(std::type_identity<F>) {
+            packed = packed && concepts::Fixed<F> && offset % sizeof(F) == 0;
+            offset += sizeof(F);
+        };
+        (place(std::type_identity<member_type<Members>>{}), ...);
+        if constexpr (std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T> &&
+                      std::is_trivially_default_constructible_v<T>)
+        {
+            return packed && offset == sizeof(T) && offset % 8 == 0 && in_memory_order();
+        }
+        else
+        {
+            return false;
+        }
+    }();
+
+    static constexpr auto fields(T& v)
+    {
+        return std::tie(v.*Members...);
+    }
+
+    static constexpr auto fields(const T& v)
+    {
+        return std::tie(v.*Members...);
+    }
+
+    static errc read_value(subctx& ctx, T& v)
+    {
+        return read_struct(ctx, v);
+    }
+
+    static errc write_value(subctx& ctx, const T& v)
+    {
+        return write_struct(ctx, v);
+    }
+
+    static errc encode_value(wire::encoder& e, const T& v)
+    {
+        return wire::encode_struct(e, v);
+    }
+
+    static errc decode_value(wire::decoder& d, T& v)
+    {
+        return wire::decode_struct(d, v);
+    }
+};
+
+template <auto... Members>
+struct members
+{};
+
+template <typename T, typename M = typename T::struct_t>
+struct default_struct_traits;
+
+template <typename T, auto... Members>
+struct default_struct_traits<T, members<Members...>> : struct_traits<T, Members...>
+{};
+
+template <concepts::Struct T>
+struct default_traits<T> : default_struct_traits<T>
 {};
 
 template <typename T>
@@ -221,6 +778,16 @@ struct default_dict_traits
     {
         return write_array(ctx, v);
     }
+
+    static errc encode_value(wire::encoder& e, const T& v)
+    {
+        return wire::encode_dict(e, v);
+    }
+
+    static errc decode_value(wire::decoder& d, T& v)
+    {
+        return wire::decode_dict(d, v);
+    }
 };
 
 template <concepts::Dict T>
@@ -241,6 +808,16 @@ struct default_traits<as_helper<T, F>>
     {
         return traits<T>::write_value(ctx, v);
     }
+
+    static errc encode_value(wire::encoder& e, const as_helper<T, F>& v)
+    {
+        return wire::encode_as(e, v);
+    }
+
+    static errc decode_value(wire::decoder& d, as_helper<T, F>& v)
+    {
+        return wire::decode_as(d, v);
+    }
 };
 
 template <typename T>
@@ -262,8 +839,125 @@ struct default_traits<variant_tag<T>>
 };
 
 template <typename C, typename V>
-struct default_traits<array_of_helper<C, V>> : default_array_traits<C>
-{};
+struct default_traits<array_of_helper<C, V>>
+{
+    static constexpr auto sig = "a" + traits<V>::sig;
+
+    /*
+     * Basic to basic conversions run over the whole array at once instead
+     * of through an as_helper per element.
+     */
+    static constexpr bool bulk = concepts::RandomAccess<C> &&
+                                 concepts::Basic<typename C::value_type> &&
+                                 concepts::Basic<typename V::target_type>;
+
+    template <typename F>
+    static errc read_value(subctx& ctx, F&& v)
+    {
+        if constexpr (bulk)
+        {
+            return read_converted_array<typename V::target_type>(ctx, v.ref);
+        }
+        else
+        {
+            return read_array(ctx, std::forward<F>(v));
+        }
+    }
+
+    template <typename F>
+    static errc write_value(subctx& ctx, F&& v)
+    {
+        if constexpr (bulk && std::same_as<typename V::target_type, bool>)
+        {
+            return write_bool_array(ctx, v.ref);
+        }
+        else if constexpr (bulk)
+        {
+            return write_converted_array<typename V::target_type>(ctx, v.ref);
+        }
+        else
+        {
+            return write_array(ctx, std::forward<F>(v));
+        }
+    }
+
+    static errc encode_value(wire::encoder& e, const array_of_helper<C, V>& v)
+    {
+        return wire::encode_array_of(e, v);
+    }
+
+    static errc decode_value(wire::decoder& d, array_of_helper<C, V>& v)
+    {
+        return wire::decode_array_of(d, v);
+    }
+};
+
+template <concepts::Container C>
+struct default_traits<presized_helper<C>>
+{
+    static constexpr auto sig = traits<C>::sig;
+
+    template <typename F>
+    static errc read_value(subctx& ctx, F&& v)
+    {
+        if constexpr (concepts::FixedContainer<C> || concepts::BasicArray<C>)
+        {
+            return traits<C>::read_value(ctx, v.ref);
+        }
+        else
+        {
+            return read_array(ctx, std::forward<F>(v));
+        }
+    }
+
+    static errc write_value(subctx& ctx, const presized_helper<C>& v)
+    {
+        return traits<C>::write_value(ctx, std::as_const(v.ref));
+    }
+
+    static errc encode_value(wire::encoder& e, const presized_helper<C>& v)
+    {
+        return traits<C>::encode_value(e, v.ref);
+    }
+
+    static errc decode_value(wire::decoder& d, presized_helper<C>& v)
+    {
+        return traits<C>::decode_value(d, v.ref);
+    }
+};
+
+/*
+ * Signature of a whole argument list, and the length and signature of its
+ * leading run of basic types, which sd-bus can marshal in a single variadic
+ * sd_bus_message_append()/sd_bus_message_read() call.
+ */
+template <typename... Ts>
+struct arg_list
+{
+    using types = std::tuple<Ts...>;
+
+    template <size_t I>
+    using type = std::tuple_element_t<I, types>;
+
+    static constexpr auto sig = (sig_string("") + ... + traits<Ts>::sig);
+
+    static constexpr size_t basic_size = [] {
+        size_t n = 0;
+        bool basic = true;
+        ((basic = basic && concepts::Basic<Ts>, n += basic), ...);
+        return n;
+    }();
+
+  private:
+    template <size_t... Is>
+    static constexpr auto make_basic_sig(std::index_sequence<Is...>)
+    {
+        return (sig_string("") + ... + traits<type<Is>>::sig);
+    }
+
+  public:
+    static constexpr auto basic_sig = make_basic_sig(std::make_index_sequence<basic_size>{});
+};
 
 } // namespace sdbus
 
@@ -0,0 +1,999 @@
+#ifndef sdbus_WIRE_HPP_
+#define sdbus_WIRE_HPP_
+
+#include <sdbus/sdbus.hpp>
+
+#include <bit>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+namespace sdbus::wire
+{
+
+/*
+ * Alignment of a value in the D-Bus wire format, by its type code.
+ */
+static constexpr size_t alignment(char type)
+{
+    switch (type)
+    {
+        case 'n':
+        case 'q':
+            return 2;
+        case 'b':
+        case 'i':
+        case 'u':
+        case 'h':
+        case 's':
+        case 'o':
+        case 'a':
+            return 4;
+        case 'x':
+        case 't':
+        case 'd':
+        case '(':
+        case '{':
+            return 8;
+        default:
+            return 1;
+    }
+}
+
+/*
+ * Length of the first complete type of a signature.
+ */
+static constexpr size_t type_length(std::string_view sig)
+{
+    if (sig.empty())
+    {
+        return 0;
+    }
+    if (sig[0] == 'a')
+    {
+        auto n = type_length(sig.substr(1));
+        return n ? n + 1 : 0;
+    }
+    if (sig[0] == '(' || sig[0] == '{')
+    {
+        size_t depth = 0;
+        for (size_t i = 0; i < sig.size(); ++i)
+        {
+            depth += sig[i] == '(' || sig[i] == '{';
+            depth -= sig[i] == ')' || sig[i] == '}';
+            if (depth == 0)
+            {
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+    return 1;
+}
+
+template <typename T>
+static constexpr T little_endian(T v) noexcept
+{
+    if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1)
+    {
+        using U = std::conditional_t<sizeof(T) == 2, uint16_t,
+                                     std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>;
+        return std::bit_cast<T>(std::byteswap(std::bit_cast<U>(v)));
+    }
+    else
+    {
+        return v;
+    }
+}
+
+/*
+ * Serializes values into a caller-owned buffer in the little-endian D-Bus
+ * wire format. Alignment padding is relative to the start of the buffer,
+ * which stands for the start of a message body.
+ */
+struct encoder
+{
+    constexpr encoder(std::span<uint8_t> buf) noexcept : _buf(buf)
+    {}
+
+    constexpr size_t size() const noexcept
+    {
+        return _pos;
+    }
+
+    constexpr std::span<const uint8_t> data() const noexcept
+    {
+        return _buf.first(_pos);
+    }
+
+    errc align(size_t a)
+    {
+        auto pad = -_pos & (a - 1);
+        if (pad > _buf.size() - _pos)
+        {
+            return errc::out_of_space;
+        }
+        std::memset(_buf.data() + _pos, 0, pad);
+        _pos += pad;
+        return errc::success;
+    }
+
+    errc put(const void* p, size_t n)
+    {
+        if (n > _buf.size() - _pos)
+        {
+            return errc::out_of_space;
+        }
+        if (n)
+        {
+            std::memcpy(_buf.data() + _pos, p, n);
+        }
+        _pos += n;
+        return errc::success;
+    }
+
+    template <typename T>
+    errc put_fixed(T v)
+    {
+        auto ec = align(sizeof(T));
+        if (no_error(ec))
+        {
+            v = little_endian(v);
+            ec = put(&v, sizeof(T));
+        }
+        return ec;
+    }
+
+    // Strings ('s', 'o') carry a 32-bit length, signatures ('g') an 8-bit one.
+    errc put_string(std::string_view s, char type = 's')
+    {
+        auto ec = type == 'g' ? put_fixed(static_cast<uint8_t>(s.size()))
+                              : put_fixed(static_cast<uint32_t>(s.size()));
+        if (no_error(ec))
+        {
+            ec = put(s.data(), s.size());
+        }
+        if (no_error(ec))
+        {
+            ec = put("", 1);
+        }
+        return ec;
+    }
+
+    /*
+     * Starts an array of elements with the given alignment; `start` receives
+     * the offset of its length, to be passed to end_array().
+     */
+    errc begin_array(size_t elem_align, size_t& start)
+    {
+        auto ec = put_fixed(uint32_t{0});
+        if (no_error(ec))
+        {
+            start = _pos - sizeof(uint32_t);
+            ec = align(elem_align);
+        }
+        return ec;
+    }
+
+    errc end_array(size_t start, size_t elem_align)
+    {
+        auto first = start + sizeof(uint32_t);
+        first += -first & (elem_align - 1);
+        auto size = _pos - first;
+        if (size > max_array_size)
+        {
+            return errc::write_error;
+        }
+        auto len = little_endian(static_cast<uint32_t>(size));
+        std::memcpy(_buf.data() + start, &len, sizeof(len));
+        return errc::success;
+    }
+
+    static constexpr size_t max_array_size = 1 << 26;
+
+  private:
+    std::span<uint8_t> _buf;
+    size_t _pos = 0;
+};
+
+/*
+ * Deserializes values from a buffer in the little-endian D-Bus wire format.
+ * Strings decoded into views point into the buffer.
+ */
+struct decoder
+{
+    constexpr decoder(std::span<const uint8_t> buf) noexcept : _buf(buf)
+    {}
+
+    constexpr size_t position() const noexcept
+    {
+        return _pos;
+    }
+
+    constexpr bool at_end() const noexcept
+    {
+        return _pos == _buf.size();
+    }
+
+    errc align(size_t a)
+    {
+        auto pad = -_pos & (a - 1);
+        if (pad > _buf.size() - _pos)
+        {
+            return errc::read_error;
+        }
+        _pos += pad;
+        return errc::success;
+    }
+
+    errc get(void* p, size_t n)
+    {
+        if (n > _buf.size() - _pos)
+        {
+            return errc::read_error;
+        }
+        if (n)
+        {
+            std::memcpy(p, _buf.data() + _pos, n);
+        }
+        _pos += n;
+        return errc::success;
+    }
+
+    errc skip(size_t n)
+    {
+        if (n > _buf.size() - _pos)
+        {
+            return errc::read_error;
+        }
+        _pos += n;
+        return errc::success;
+    }
+
+    template <typename T>
+    errc get_fixed(T& v)
+    {
+        auto ec = align(sizeof(T));
+        if (no_error(ec))
+        {
+            ec = get(&v, sizeof(T));
+        }
+        if (no_error(ec))
+        {
+            v = little_endian(v);
+        }
+        return ec;
+    }
+
+    // Returns a pointer to the NUL-terminated string in the buffer.
+    errc get_string(const char*& s, size_t& size, char type = 's')
+    {
+        errc ec;
+        if (type == 'g')
+        {
+            uint8_t len = 0;
+            ec = get_fixed(len);
+            size = len;
+        }
+        else
+        {
+            uint32_t len = 0;
+            ec = get_fixed(len);
+            size = len;
+        }
+        if (no_error(ec))
+        {
+            if (size >= _buf.size() - _pos || _buf[_pos + size] != 0)
+            {
+                return errc::read_error;
+            }
+            s = reinterpret_cast<const char*>(_buf.data() + _pos);
+            _pos += size + 1;
+        }
+        return ec;
+    }
+
+    /*
+     * Enters an array of elements with the given alignment; `end` receives
+     * the offset just past its last element.
+     */
+    errc get_array(size_t elem_align, size_t& end)
+    {
+        uint32_t len = 0;
+        auto ec = get_fixed(len);
+        if (no_error(ec))
+        {
+            ec = align(elem_align);
+        }
+        if (no_error(ec))
+        {
+            if (len > _buf.size() - _pos)
+            {
+                return errc::read_error;
+            }
+            end = _pos + len;
+        }
+        return ec;
+    }
+
+  private:
+    std::span<const uint8_t> _buf;
+    size_t _pos = 0;
+};
+
+template <typename T>
+static constexpr bool is_variant_tag = false;
+
+template <typename T>
+static constexpr bool is_variant_tag<variant_tag<T>> = true;
+
+template <typename T>
+struct array_of_traits;
+
+template <typename C, typename V>
+struct array_of_traits<array_of_helper<C, V>>
+{
+    using container_type = C;
+    using item_type = V;
+};
+
+template <typename T>
+static constexpr char type_code = traits<T>::sig.c_str()[0];
+
+// Arrays whose memory image is their wire form, copied in one piece.
+template <typename T>
+static constexpr bool is_fixed_array =
+    concepts::BasicArray<T> ||
+    (concepts::Contiguous<T> && std::endian::native == std::endian::little &&
+     requires { requires traits<typename T::value_type>::layout_compatible; });
+
+/*
+ * Values are encoded and decoded by the encode_value()/decode_value() hooks
+ * of their traits, which the default traits forward to the functions below.
+ */
+template <typename T>
+static errc encode(encoder& e, const T& v)
+{
+    if constexpr (requires { traits<T>::encode_value(e, v); })
+    {
+        return traits<T>::encode_value(e, v);
+    }
+    else
+    {
+        static_assert(false, "Type-specific wire encoding not defined.");
+        return errc::write_error;
+    }
+}
+
+template <typename T>
+static errc decode(decoder& d, T& v)
+{
+    if constexpr (requires { traits<T>::decode_value(d, v); })
+    {
+        return traits<T>::decode_value(d, v);
+    }
+    else
+    {
+        static_assert(false, "Type-specific wire decoding not defined.");
+        return errc::read_error;
+    }
+}
+
+template <typename T>
+static errc encode_basic(encoder& e, const T& v)
+{
+    if constexpr (std::same_as<T, bool>)
+    {
+        return e.put_fixed(uint32_t{v});
+    }
+    else
+    {
+        return e.put_fixed(v);
+    }
+}
+
+template <typename T>
+static errc encode_string(encoder& e, const T& v)
+{
+    return e.put_string(std::string_view(v), type_code<T> == 'g' ? 'g' : 's');
+}
+
+/*
+ * Writes a value as the contents of a variant: std::variant values carry
+ * the signature of their active alternative, others that of their type.
+ */
+template <typename T>
+static errc encode_variant(encoder& e, const T& v)
+{
+    auto put = [&]<typename V>(const V& value) {
+        auto ec = e.put_string(traits<V>::sig, 'g');
+        if (no_error(ec))
+        {
+            ec = encode(e, value);
+        }
+        return ec;
+    };
+
+    if constexpr (concepts::Variant<T>)
+    {
+        return std::visit(put, v);
+    }
+    else
+    {
+        return put(v);
+    }
+}
+
+template <typename T>
+static errc encode_struct(encoder& e, const T& v)
+{
+    auto ec = e.align(8);
+    std::apply(
+        [&](auto&... fields) {
+            (void)(no_error(ec) && ... && no_error(ec = encode(e, fields)));
+        },
+        traits<T>::fields(v));
+    return ec;
+}
+
+template <typename T>
+static errc encode_dict_entry(encoder& e, const T& v)
+{
+    auto ec = e.align(8);
+    if (no_error(ec))
+    {
+        ec = encode(e, v.first);
+    }
+    if (no_error(ec))
+    {
+        ec = encode(e, v.second);
+    }
+    return ec;
+}
+
+template <typename V, typename T, typename F>
+static errc encode_items(encoder& e, const T& items, F&& encode_item)
+{
+    size_t start;
+    auto ec = e.begin_array(alignment(type_code<V>), start);
+    for (auto it = items.begin(); no_error(ec) && it != items.end(); ++it)
+    {
+        ec = encode_item(*it);
+    }
+    if (no_error(ec))
+    {
+        ec = e.end_array(start, alignment(type_code<V>));
+    }
+    return ec;
+}
+
+template <typename T>
+static errc encode_array(encoder& e, const T& v)
+{
+    using value_type = typename T::value_type;
+
+    if constexpr (is_fixed_array<T>)
+    {
+        constexpr auto align = alignment(type_code<value_type>);
+
+        size_t start;
+        auto ec = e.begin_array(align, start);
+        if (no_error(ec))
+        {
+            if constexpr (std::endian::native == std::endian::little)
+            {
+                ec = e.put(std::data(v), std::size(v) * sizeof(value_type));
+            }
+            else
+            {
+                for (auto it = v.begin(); no_error(ec) && it != v.end(); ++it)
+                {
+                    ec = e.put_fixed(*it);
+                }
+            }
+        }
+        if (no_error(ec))
+        {
+            ec = e.end_array(start, align);
+        }
+        return ec;
+    }
+    else
+    {
+        return encode_items<value_type>(e, v, [&](const value_type& item) {
+            return element_traits<value_type>::encode_value(e, item);
+        });
+    }
+}
+
+template <typename T>
+static errc encode_dict(encoder& e, const T& v)
+{
+    size_t start;
+    auto ec = e.begin_array(8, start);
+
+    auto encode_props = [&]<typename... Ps>(std::type_identity<std::tuple<Ps...>>) {
+        auto encode_prop = [&]<typename P>(std::type_identity<P>) {
+            typename P::const_reference value{v.*P::pointer};
+            auto ec = e.align(8);
+            if (no_error(ec))
+            {
+                ec = e.put_string(P::name);
+            }
+            if (no_error(ec))
+            {
+                ec = encode_variant(e, value);
+            }
+            return ec;
+        };
+        (void)(no_error(ec) && ... && no_error(ec = encode_prop(std::type_identity<Ps>{})));
+    };
+    encode_props(std::type_identity<typename T::dict_t>{});
+
+    if (no_error(ec))
+    {
+        ec = e.end_array(start, 8);
+    }
+    return ec;
+}
+
+// Encodes the referenced value as the helper's target type.
+template <typename T>
+static errc encode_as(encoder& e, const T& v)
+{
+    using target_type = typename T::target_type;
+    if constexpr (is_variant_tag<target_type>)
+    {
+        return encode_variant(e, v.ref);
+    }
+    else
+    {
+        return encode(e, static_cast<target_type>(v.ref));
+    }
+}
+
+template <typename T>
+static errc encode_array_of(encoder& e, const T& v)
+{
+    using V = typename array_of_traits<T>::item_type;
+    using item_type = as_helper<typename V::target_type, const typename V::source_type>;
+    return encode_items<V>(e, v.ref, [&](const auto& item) { return encode(e, item_type{item}); });
+}
+
+/*
+ * Steps over one complete value of the type at the start of `sig`, and
+ * advances `sig` past that type.
+ */
+static errc skip(decoder& d, std::string_view& sig)
+{
+    if (sig.empty())
+    {
+        return errc::invalid_type;
+    }
+
+    auto c = sig[0];
+    auto len = type_length(sig);
+    if (len == 0)
+    {
+        return errc::invalid_type;
+    }
+
+    errc ec;
+    switch (c)
+    {
+        case 'y':
+        case 'n':
+        case 'q':
+        case 'b':
+        case 'i':
+        case 'u':
+        case 'h':
+        case 'x':
+        case 't':
+        case 'd':
+            ec = d.align(alignment(c));
+            if (no_error(ec))
+            {
+                ec = d.skip(c == 'y' ? 1 : alignment(c));
+            }
+            break;
+        case 's':
+        case 'o':
+        case 'g':
+        {
+            const char* s;
+            size_t n;
+            ec = d.get_string(s, n, c);
+            break;
+        }
+        case 'v':
+        {
+            const char* s;
+            size_t n;
+            ec = d.get_string(s, n, 'g');
+            if (no_error(ec))
+            {
+                std::string_view inner(s, n);
+                ec = skip(d, inner);
+                if (no_error(ec) && !inner.empty())
+                {
+                    ec = errc::invalid_type;
+                }
+            }
+            break;
+        }
+        case 'a':
+        {
+            size_t end;
+            ec = d.get_array(alignment(sig[1]), end);
+            if (no_error(ec))
+            {
+                ec = d.skip(end - d.position());
+            }
+            break;
+        }
+        case '(':
+        case '{':
+        {
+            auto inner = sig.substr(1, len - 2);
+            ec = d.align(8);
+            while (no_error(ec) && !inner.empty())
+            {
+                ec = skip(d, inner);
+            }
+            break;
+        }
+        default:
+            return errc::invalid_type;
+    }
+
+    sig.remove_prefix(len);
+    return ec;
+}
+
+template <typename T>
+static errc decode_basic(decoder& d, T& v)
+{
+    if constexpr (std::same_as<T, bool>)
+    {
+        uint32_t tmp;
+        auto ec = d.get_fixed(tmp);
+        if (no_error(ec))
+        {
+            if (tmp > 1)
+            {
+                return errc::invalid_type;
+            }
+            v = tmp;
+        }
+        return ec;
+    }
+    else
+    {
+        return d.get_fixed(v);
+    }
+}
+
+template <typename T>
+static errc decode_string(decoder& d, T& v)
+{
+    const char* s;
+    size_t n;
+    auto ec = d.get_string(s, n, type_code<T> == 'g' ? 'g' : 's');
+    if (no_error(ec))
+    {
+        try
+        {
+            if constexpr (requires { v.assign(s, n); })
+            {
+                v.assign(s, n);
+            }
+            else
+            {
+                v = s;
+            }
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = errc::no_memory;
+        }
+    }
+    return ec;
+}
+
+/*
+ * Reads the contents of a variant. A std::variant takes the alternative
+ * named by the signature, any other type has to match it.
+ */
+template <typename T>
+static errc decode_variant(decoder& d, T& v)
+{
+    const char* s;
+    size_t n;
+    auto ec = d.get_string(s, n, 'g');
+    if (is_error(ec))
+    {
+        return ec;
+    }
+
+    if constexpr (concepts::Variant<T>)
+    {
+        auto decode_alt = [&]<size_t... Is>(size_t index, std::index_sequence<Is...>) {
+            auto ec = errc::bad_variant;
+            auto decode_one = [&]<size_t I>(std::integral_constant<size_t, I>) {
+                try
+                {
+                    v.template emplace<I>();
+                }
+                catch (std::bad_alloc&)
+                {
+                    return errc::no_memory;
+                }
+                catch (...)
+                {
+                    return errc::bad_exception;
+                }
+                return decode(d, std::get<I>(v));
+            };
+            (void)((index == Is && (ec = decode_one(std::integral_constant<size_t, Is>{}), true)) ||
+                   ...);
+            return ec;
+        };
+
+        return decode_alt(variant_index<T>::find(s),
+                          std::make_index_sequence<std::variant_size_v<T>>{});
+    }
+    else
+    {
+        if (std::string_view(s, n) != std::string_view(traits<T>::sig))
+        {
+            return errc::invalid_type;
+        }
+        return decode(d, v);
+    }
+}
+
+template <typename T>
+static errc decode_struct(decoder& d, T& v)
+{
+    auto ec = d.align(8);
+    std::apply(
+        [&](auto&... fields) {
+            (void)(no_error(ec) && ... && no_error(ec = decode(d, fields)));
+        },
+        traits<T>::fields(v));
+    return ec;
+}
+
+template <typename T>
+static errc decode_dict_entry(decoder& d, T& v)
+{
+    auto ec = d.align(8);
+    if (no_error(ec))
+    {
+        ec = decode(d, v.first);
+    }
+    if (no_error(ec))
+    {
+        ec = decode(d, v.second);
+    }
+    return ec;
+}
+
+template <typename T, typename F>
+static errc decode_items(decoder& d, F&& decode_item)
+{
+    size_t end;
+    auto ec = d.get_array(alignment(type_code<T>), end);
+    while (no_error(ec) && d.position() < end)
+    {
+        ec = decode_item();
+    }
+    if (no_error(ec) && d.position() != end)
+    {
+        ec = errc::read_error;
+    }
+    return ec;
+}
+
+// Decodes an element through its item type, e.g. the as_helper of as_array_of().
+template <typename V, typename T>
+static errc decode_item(decoder& d, T& v)
+{
+    if constexpr (std::same_as<V, T>)
+    {
+        return element_traits<V>::decode_value(d, v);
+    }
+    else
+    {
+        V item(v);
+        return decode(d, item);
+    }
+}
+
+template <typename T, typename V>
+static errc decode_container(decoder& d, T& v)
+{
+    using value_type = typename value_type_traits<typename T::value_type>::type;
+
+    if constexpr (concepts::Emplaceable<T>)
+    {
+        return decode_items<V>(d, [&] {
+            value_type item{};
+            auto ec = decode_item<V>(d, item);
+            if (no_error(ec))
+            {
+                try
+                {
+                    if constexpr (concepts::HasEmplace<T>)
+                    {
+                        v.emplace(std::move(item));
+                    }
+                    else
+                    {
+                        v.emplace(v.end(), std::move(item));
+                    }
+                }
+                catch (std::bad_alloc&)
+                {
+                    ec = errc::no_memory;
+                }
+                catch (...)
+                {
+                    ec = errc::bad_exception;
+                }
+            }
+            return ec;
+        });
+    }
+    else
+    {
+        size_t i = 0;
+        return decode_items<V>(d, [&] {
+            if (i == v.size())
+            {
+                return errc::out_of_space;
+            }
+            return decode_item<V>(d, v[i++]);
+        });
+    }
+}
+
+template <typename T>
+static errc decode_array(decoder& d, T& v)
+{
+    if constexpr (is_fixed_array<T>)
+    {
+        using value_type = typename T::value_type;
+
+        size_t end;
+        auto ec = d.get_array(alignment(type_code<value_type>), end);
+        if (is_error(ec))
+        {
+            return ec;
+        }
+
+        auto size = end - d.position();
+        if (size % sizeof(value_type))
+        {
+            return errc::read_error;
+        }
+
+        auto count = size / sizeof(value_type);
+        size_t offset = 0;
+        if constexpr (concepts::Resizable<T>)
+        {
+            offset = v.size();
+            try
+            {
+                v.resize(offset + count);
+            }
+            catch (std::bad_alloc&)
+            {
+                return errc::no_memory;
+            }
+        }
+        else if (count > v.size())
+        {
+            return errc::out_of_space;
+        }
+
+        ec = d.get(v.data() + offset, size);
+        if constexpr (std::endian::native != std::endian::little)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                v[offset + i] = little_endian(v[offset + i]);
+            }
+        }
+        return ec;
+    }
+    else
+    {
+        return decode_container<T, typename value_type_traits<typename T::value_type>::type>(d, v);
+    }
+}
+
+template <typename T>
+static errc decode_dict(decoder& d, T& v)
+{
+    using table = property_table<T>;
+
+    auto decode_prop = [&]<size_t... Is>(size_t index, std::index_sequence<Is...>) {
+        auto ec = errc::invalid_property;
+        auto decode_one = [&]<size_t I>(std::integral_constant<size_t, I>) {
+            using P = std::tuple_element_t<I, typename T::dict_t>;
+            typename P::reference value{v.*P::pointer};
+            return decode_variant(d, value);
+        };
+        (void)((index == Is && (ec = decode_one(std::integral_constant<size_t, Is>{}), true)) ||
+               ...);
+        return ec;
+    };
+
+    size_t end;
+    auto ec = d.get_array(8, end);
+    while (no_error(ec) && d.position() < end)
+    {
+        const char* name;
+        size_t n;
+        ec = d.align(8);
+        if (no_error(ec))
+        {
+            ec = d.get_string(name, n);
+        }
+        if (is_error(ec))
+        {
+            break;
+        }
+
+        auto desc = table::find(std::string_view(name, n));
+        if (desc == nullptr)
+        {
+            std::string_view sig = "v";
+            ec = skip(d, sig);
+        }
+        else
+        {
+            ec = decode_prop(table::index_of(desc),
+                             std::make_index_sequence<table::descs.size()>{});
+        }
+    }
+    if (no_error(ec) && d.position() != end)
+    {
+        ec = errc::read_error;
+    }
+    return ec;
+}
+
+// Decodes a value of the helper's target type into the referenced value.
+template <typename T>
+static errc decode_as(decoder& d, T& v)
+{
+    using target_type = typename T::target_type;
+    if constexpr (is_variant_tag<target_type>)
+    {
+        return decode_variant(d, v.ref);
+    }
+    else
+    {
+        target_type tmp{};
+        auto ec = decode(d, tmp);
+        if (no_error(ec))
+        {
+            v.ref = static_cast<typename T::source_type>(tmp);
+        }
+        return ec;
+    }
+}
+
+template <typename T>
+static errc decode_array_of(decoder& d, T& v)
+{
+    using A = array_of_traits<T>;
+    return decode_container<typename A::container_type, typename A::item_type>(d, v.ref);
+}
+
+} // namespace sdbus::wire
+
+#endif // sdbus_WIRE_HPP_
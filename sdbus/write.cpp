@@ -69,48 +69,42 @@ errc write_basic(subctx& ctx, const double& v)
 
 errc write_variant_impl(subctx& ctx, const char* sig, writer_base& writer)
 {
-    auto msg = ctx.msg();
-    auto ec = sdbus_errc(sd_bus_message_open_container(msg, SD_BUS_TYPE_VARIANT, sig));
-    if (no_error(ec))
-    {
-        ec = writer.write_value(ctx);
-        sd_bus_message_close_container(msg);
-    }
-    return ec;
+    return write_variant_inline(ctx, sig, writer);
 }
 
 errc write_dict_entry_impl(subctx& ctx, const char* sig, writer_base& writer)
 {
-    auto msg = ctx.msg();
-    auto ec = sdbus_errc(sd_bus_message_open_container(msg, SD_BUS_TYPE_DICT_ENTRY, sig));
-    if (no_error(ec))
-    {
-        ec = writer.write_value(ctx);
-        sd_bus_message_close_container(msg);
-    }
-    return ec;
+    return write_dict_entry_inline(ctx, sig, writer);
+}
+
+errc write_struct_impl(subctx& ctx, const char* sig, writer_base& writer)
+{
+    return write_struct_inline(ctx, sig, writer);
 }
 
 errc write_array_impl(subctx& ctx, const char* sig, size_t size, writer_base& writer)
 {
-    auto msg = ctx.msg();
-    auto ec = sdbus_errc(sd_bus_message_open_container(msg, SD_BUS_TYPE_ARRAY, sig));
-    if (no_error(ec))
-    {
-        auto index = 0;
-
-        while (size--)
-        {
-            subctx ictx(index++, ctx);
-            ec = writer.write_value(ictx);
-            if (is_error(ec))
-            {
-                break;
-            }
-        }
-        sd_bus_message_close_container(msg);
-    }
-    return ec;
+    return write_array_inline(ctx, sig, size, writer);
+}
+
+errc write_range_impl(subctx& ctx, const char* sig, range_writer_base& writer)
+{
+    return write_range_inline(ctx, sig, writer);
+}
+
+errc write_basic_array_impl(subctx& ctx, const char* type, const void* data, size_t size)
+{
+    return sdbus_errc(sd_bus_message_append_array(ctx.msg(), type[0], data, size));
+}
+
+errc write_string_space_impl(subctx& ctx, size_t size, char** buf)
+{
+    return sdbus_errc(sd_bus_message_append_string_space(ctx.msg(), size, buf));
+}
+
+errc write_array_space_impl(subctx& ctx, const char* type, size_t size, void** buf)
+{
+    return sdbus_errc(sd_bus_message_append_array_space(ctx.msg(), type[0], size, buf));
 }
 
 } // namespace sdbus
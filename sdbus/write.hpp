@@ -2,7 +2,9 @@
 #define sdbus_WRITE_HPP_
 
 #include <sdbus/concepts.hpp>
+#include <sdbus/convert.hpp>
 #include <sdbus/property.hpp>
+#include <sdbus/traits.hpp>
 
 namespace sdbus
 {
@@ -10,7 +12,7 @@ namespace sdbus
 template <typename T>
 static errc write(sd_bus_message* msg, const T& v)
 {
-    defctx ctx(msg);
+    context<error_policy::fail_fast> ctx(msg);
     return write(ctx, v);
 }
 
@@ -21,10 +23,72 @@ static errc write(subctx& ctx, const T& v)
     return traits<type>::write_value(ctx, v);
 }
 
+/*
+ * Ranges that can't be iterated when const are taken by forwarding
+ * reference and consumed by the write.
+ */
+template <typename T>
+    requires(concepts::MutableRange<std::remove_cvref_t<T>> &&
+             !std::is_const_v<std::remove_reference_t<T>>)
+static errc write(sd_bus_message* msg, T&& v)
+{
+    context<error_policy::fail_fast> ctx(msg);
+    return write(ctx, v);
+}
+
+template <typename T>
+    requires(concepts::MutableRange<std::remove_cvref_t<T>> &&
+             !std::is_const_v<std::remove_reference_t<T>>)
+static errc write(subctx& ctx, T&& v)
+{
+    return traits<std::remove_cvref_t<T>>::write_value(ctx, v);
+}
+
+template <typename... Ts>
+static errc write_all(sd_bus_message* msg, const Ts&... v)
+{
+    context<error_policy::fail_fast> ctx(msg);
+    return write_all(ctx, v...);
+}
+
+/*
+ * Writes a whole argument list: the leading run of basic values goes in
+ * with one sd_bus_message_append() call, the rest is written one by one.
+ */
+template <typename... Ts>
+static errc write_all(subctx& ctx, const Ts&... v)
+{
+    using args = arg_list<Ts...>;
+
+    auto refs = std::tie(v...);
+    auto write_args = [&]<size_t... Is, size_t... Js>(std::index_sequence<Is...>,
+                                                     std::index_sequence<Js...>) {
+        auto ec = errc::success;
+        if constexpr (sizeof...(Is) > 0)
+        {
+            ec = sdbus_errc(sd_bus_message_append(ctx.msg(), args::basic_sig, std::get<Is>(refs)...));
+        }
+        (void)(no_error(ec) && ... &&
+               no_error(ec = write(ctx, std::get<args::basic_size + Js>(refs))));
+        return ec;
+    };
+
+    return write_args(std::make_index_sequence<args::basic_size>{},
+                      std::make_index_sequence<sizeof...(Ts) - args::basic_size>{});
+}
+
 template <typename T>
 static errc write_string(subctx& ctx, const T& v)
 {
     string_write_helper wh(v);
+    if constexpr (!decltype(wh)::terminated)
+    {
+        // Views need not be NUL-terminated, copy them by size where sd-bus allows it.
+        if (wh.sig()[0] == 's')
+        {
+            return write(ctx, concat(wh.view()));
+        }
+    }
     return write_basic_impl(ctx, wh.sig(), wh.data());
 }
 
@@ -33,6 +97,127 @@ struct writer_base
     virtual errc write_value(subctx&) = 0;
 };
 
+template <typename W>
+static constexpr errc invoke_writer(subctx& ctx, W& writer)
+{
+    if constexpr (std::is_abstract_v<W>)
+    {
+        return writer.write_value(ctx);
+    }
+    else
+    {
+        return writer.W::write_value(ctx);
+    }
+}
+
+template <typename W>
+static errc write_variant_inline(subctx& ctx, const char* sig, W& writer)
+{
+    auto msg = ctx.msg();
+    auto ec = sdbus_errc(sd_bus_message_open_container(msg, SD_BUS_TYPE_VARIANT, sig));
+    if (no_error(ec))
+    {
+        ec = invoke_writer(ctx, writer);
+        sd_bus_message_close_container(msg);
+    }
+    return ec;
+}
+
+template <typename W>
+static errc write_dict_entry_inline(subctx& ctx, const char* sig, W& writer)
+{
+    auto msg = ctx.msg();
+    auto ec = sdbus_errc(sd_bus_message_open_container(msg, SD_BUS_TYPE_DICT_ENTRY, sig));
+    if (no_error(ec))
+    {
+        ec = invoke_writer(ctx, writer);
+        sd_bus_message_close_container(msg);
+    }
+    return ec;
+}
+
+template <typename W>
+static errc write_struct_inline(subctx& ctx, const char* sig, W& writer)
+{
+    auto msg = ctx.msg();
+    auto ec = sdbus_errc(sd_bus_message_open_container(msg, SD_BUS_TYPE_STRUCT, sig));
+    if (no_error(ec))
+    {
+        ec = invoke_writer(ctx, writer);
+        sd_bus_message_close_container(msg);
+    }
+    return ec;
+}
+
+template <bool TrackPath, typename W>
+static errc write_element(subctx& ctx, size_t index, W& writer)
+{
+    if constexpr (TrackPath)
+    {
+        subctx ictx(index, ctx);
+        return invoke_writer(ictx, writer);
+    }
+    else
+    {
+        return invoke_writer(ctx, writer);
+    }
+}
+
+template <typename W>
+static errc write_array_inline(subctx& ctx, const char* sig, size_t size, W& writer)
+{
+    auto msg = ctx.msg();
+    auto ec = sdbus_errc(sd_bus_message_open_container(msg, SD_BUS_TYPE_ARRAY, sig));
+    if (no_error(ec))
+    {
+        ec = ctx.with_path_tracking([&]<bool TrackPath>(std::bool_constant<TrackPath>) {
+            for (size_t i = 0; i < size; ++i)
+            {
+                auto r = write_element<TrackPath>(ctx, i, writer);
+                if (is_error(r))
+                {
+                    return r;
+                }
+            }
+            return errc::success;
+        });
+        sd_bus_message_close_container(msg);
+    }
+    return ec;
+}
+
+/*
+ * Writer of an array whose length isn't known up front: elements are
+ * written until the writer reports the end.
+ */
+struct range_writer_base : writer_base
+{
+    virtual bool at_end() = 0;
+};
+
+template <typename W>
+static errc write_range_inline(subctx& ctx, const char* sig, W& writer)
+{
+    auto msg = ctx.msg();
+    auto ec = sdbus_errc(sd_bus_message_open_container(msg, SD_BUS_TYPE_ARRAY, sig));
+    if (no_error(ec))
+    {
+        ec = ctx.with_path_tracking([&]<bool TrackPath>(std::bool_constant<TrackPath>) {
+            for (size_t i = 0; !writer.at_end(); ++i)
+            {
+                auto r = write_element<TrackPath>(ctx, i, writer);
+                if (is_error(r))
+                {
+                    return r;
+                }
+            }
+            return errc::success;
+        });
+        sd_bus_message_close_container(msg);
+    }
+    return ec;
+}
+
 template <typename T>
 struct simple_writer : writer_base
 {
@@ -100,14 +285,21 @@ template <typename T>
 errc write_variant(subctx& ctx, const T& v)
 {
     auto w = variant_writer<T>(v);
-    return write_variant_impl(ctx, w.signature(), w);
+    if constexpr (inline_codec)
+    {
+        return write_variant_inline(ctx, w.signature(), w);
+    }
+    else
+    {
+        return write_variant_impl(ctx, w.signature(), w);
+    }
 }
 
 template <typename T>
 struct dict_entry_writer : writer_base
 {
-    using T1 = typename T::first_type;
-    using T2 = typename T::second_type;
+    using T1 = std::remove_cv_t<typename T::first_type>;
+    using T2 = std::remove_cv_t<typename T::second_type>;
 
     static constexpr auto sig = traits<T1>::sig + traits<T2>::sig;
 
@@ -137,7 +329,54 @@ template <typename T>
 errc write_dict_entry(subctx& ctx, const T& v)
 {
     auto w = dict_entry_writer<T>(v);
-    return write_dict_entry_impl(ctx, w.signature(), w);
+    if constexpr (inline_codec)
+    {
+        return write_dict_entry_inline(ctx, w.signature(), w);
+    }
+    else
+    {
+        return write_dict_entry_impl(ctx, w.signature(), w);
+    }
+}
+
+template <typename T>
+struct struct_writer : writer_base
+{
+    constexpr struct_writer(const T& v) : _v{v}
+    {}
+
+    const char* signature() const
+    {
+        return traits<T>::contents;
+    }
+
+    errc write_value(subctx& ctx) override
+    {
+        return std::apply(
+            [&](auto&... fields) {
+                auto ec = errc::success;
+                (void)(no_error(ec = write(ctx, fields)) && ...);
+                return ec;
+            },
+            traits<T>::fields(_v));
+    }
+
+  private:
+    const T& _v;
+};
+
+template <typename T>
+errc write_struct(subctx& ctx, const T& v)
+{
+    auto w = struct_writer<T>(v);
+    if constexpr (inline_codec)
+    {
+        return write_struct_inline(ctx, w.signature(), w);
+    }
+    else
+    {
+        return write_struct_impl(ctx, w.signature(), w);
+    }
 }
 
 template <typename T>
@@ -164,7 +403,7 @@ struct container_writer : writer_base
 
     const char* signature() const
     {
-        return static_cast<const char*>(traits<item_type>::sig);
+        return static_cast<const char*>(element_traits<item_type>::sig);
     }
 
     size_t size() const
@@ -172,9 +411,17 @@ struct container_writer : writer_base
         return _size;
     }
 
-    errc write_value(subctx& ctx)
+    errc write_value(subctx& ctx) override
     {
-        return write<item_type>(ctx, *_pos++);
+        if constexpr (requires { typename item_type::target_type; })
+        {
+            return write(ctx, as<typename item_type::target_type>(*_pos++));
+        }
+        else
+        {
+            const item_type& item = *_pos++;
+            return element_traits<item_type>::write_value(ctx, item);
+        }
     }
 
   private:
@@ -191,10 +438,45 @@ struct item_writer<T> : container_writer<T>
 template <typename C, typename V>
 struct item_writer<array_of_helper<C, V>> : container_writer<C, V>
 {
-    constexpr item_writer(array_of_helper<C, V>& v) : container_writer<C, V>(v.ref)
+    constexpr item_writer(const array_of_helper<C, V>& v) : container_writer<C, V>(v.ref)
     {}
 };
 
+/*
+ * Writes the elements of a view or generator as they are produced. R is
+ * const-qualified unless the range can only be iterated when non-const.
+ */
+template <typename R>
+struct range_writer final : range_writer_base
+{
+    using item_type = std::ranges::range_value_t<R>;
+
+    range_writer(R& v) : _range(v), _pos(std::ranges::begin(_range))
+    {}
+
+    const char* signature() const
+    {
+        return element_traits<item_type>::sig;
+    }
+
+    bool at_end() override
+    {
+        return _pos == std::ranges::end(_range);
+    }
+
+    errc write_value(subctx& ctx) override
+    {
+        const item_type& item = *_pos;
+        auto ec = element_traits<item_type>::write_value(ctx, item);
+        ++_pos;
+        return ec;
+    }
+
+  private:
+    R& _range;
+    std::ranges::iterator_t<R> _pos;
+};
+
 struct dict_writer_base : writer_base
 {
     const char* signature() const
@@ -206,37 +488,39 @@ struct dict_writer_base : writer_base
 template <typename T>
 struct dict_writer : dict_writer_base
 {
-    dict_writer(const T& v) : _compound(v), _descs(make_descs())
+    dict_writer(const T& v) : _compound(v)
     {}
 
     size_t size() const
     {
-        return _descs.size();
+        return property_table<T>::descs.size();
     }
 
-  protected:
     errc write_value(subctx& ctx) override
     {
-        const auto& desc = _descs[ctx.index()];
-        auto ec = write(ctx, desc.name());
+        return write_entry(ctx, property_table<T>::descs[_index++]);
+    }
+
+  protected:
+    errc write_entry(subctx& ctx, const property_desc<T>& desc)
+    {
+        auto msg = ctx.msg();
+        auto ec = sdbus_errc(sd_bus_message_open_container(msg, SD_BUS_TYPE_DICT_ENTRY, "sv"));
         if (no_error(ec))
         {
-            ec = desc.write_value(ctx, _compound);
+            ec = write(ctx, desc.name());
+            if (no_error(ec))
+            {
+                ec = desc.write_value(ctx, _compound);
+            }
+            sd_bus_message_close_container(msg);
         }
 
         return ec;
     }
 
-  private:
-    static constexpr auto make_descs()
-    {
-        using props = typename T::dict_t;
-        return property_desc_maker<props>::make_descs();
-    }
-
-  private:
     const T& _compound;
-    property_descs<T> _descs;
+    size_t _index = 0;
 };
 
 template <concepts::Dict T>
@@ -245,11 +529,133 @@ struct item_writer<T> : dict_writer<T>
     using dict_writer<T>::dict_writer;
 };
 
+template <typename T>
+struct item_writer<projection<T>> : dict_writer<std::remove_const_t<T>>
+{
+    using value_type = std::remove_const_t<T>;
+
+    item_writer(const projection<T>& v) : dict_writer<value_type>(v.ref), _mask(v.mask)
+    {}
+
+    size_t size() const
+    {
+        return _mask.count();
+    }
+
+    errc write_value(subctx& ctx) override
+    {
+        while (!_mask.test(this->_index))
+        {
+            ++this->_index;
+        }
+        return this->write_entry(ctx, property_table<value_type>::descs[this->_index++]);
+    }
+
+  private:
+    const property_mask<T>& _mask;
+};
+
+template <typename T>
+struct item_writer<property_names<T>> : writer_base
+{
+    item_writer(const property_names<T>& v) : _mask(v.mask)
+    {}
+
+    const char* signature() const
+    {
+        return "s";
+    }
+
+    size_t size() const
+    {
+        return _mask.count();
+    }
+
+    errc write_value(subctx& ctx) override
+    {
+        while (!_mask.test(_index))
+        {
+            ++_index;
+        }
+        return write(ctx, property_table<T>::descs[_index++].name());
+    }
+
+  private:
+    const property_mask<T>& _mask;
+    size_t _index = 0;
+};
+
 template <typename T>
 static errc write_array(subctx& ctx, const T& v)
 {
     item_writer<T> w(v);
-    return write_array_impl(ctx, w.signature(), w.size(), w);
+    if constexpr (inline_codec)
+    {
+        return write_array_inline(ctx, w.signature(), w.size(), w);
+    }
+    else
+    {
+        return write_array_impl(ctx, w.signature(), w.size(), w);
+    }
+}
+
+template <typename R>
+static errc write_range(subctx& ctx, R& v)
+{
+    range_writer<R> w(v);
+    if constexpr (inline_codec)
+    {
+        return write_range_inline(ctx, w.signature(), w);
+    }
+    else
+    {
+        return write_range_impl(ctx, w.signature(), w);
+    }
+}
+
+/*
+ * Writes a container of basic values as an array of fixed type S,
+ * converting straight into space reserved in the message.
+ */
+template <typename S, typename T>
+static errc write_converted_array(subctx& ctx, const T& v)
+{
+    static_assert(concepts::Fixed<S>, "Only fixed-size elements can be reserved.");
+
+    auto count = std::size(v);
+    void* buf;
+    auto ec = write_array_space_impl(ctx, traits<S>::sig, count * sizeof(S), &buf);
+    if (no_error(ec))
+    {
+        convert_elements(std::begin(v), count, static_cast<S*>(buf));
+    }
+    return ec;
+}
+
+/*
+ * sd-bus refuses to reserve boolean arrays, as it has to check each value,
+ * so these go through the array writer with each element converted to bool.
+ */
+template <typename T>
+static errc write_bool_array(subctx& ctx, const T& v)
+{
+    container_writer<T, bool> w(v);
+    if constexpr (inline_codec)
+    {
+        return write_array_inline(ctx, w.signature(), w.size(), w);
+    }
+    else
+    {
+        return write_array_impl(ctx, w.signature(), w.size(), w);
+    }
+}
+
+template <typename T>
+static errc write_basic_array(subctx& ctx, const T& v)
+{
+    using value_type = typename T::value_type;
+    return write_basic_array_impl(ctx, traits<value_type>::sig, std::data(v),
+                                  std::size(v) * sizeof(value_type));
 }
 
 } // namespace sdbus
@@ -23,6 +23,13 @@ struct dict_s
 
 using prop = property<"a", &dict_s::a>;
 
+struct struct_s
+{
+    int a;
+    std::string b;
+    using struct_t = members<&struct_s::a, &struct_s::b>;
+};
+
 struct pairlike
 {
     using first_type = int;
@@ -60,6 +67,24 @@ TEST(Concepts, Basic)
     EXPECT_FALSE(concepts::Basic<std::string>);
 }
 
+enum plain_enum
+{
+    plain_value,
+};
+
+enum class scoped_enum : int16_t
+{
+    value,
+};
+
+TEST(Concepts, Enum)
+{
+    EXPECT_TRUE(concepts::Enum<scoped_enum>);
+    EXPECT_FALSE(concepts::Enum<plain_enum>);
+    EXPECT_FALSE(concepts::Enum<int16_t>);
+    EXPECT_EQ(traits<scoped_enum>::sig, "n");
+}
+
 TEST(Concepts, String)
 {
     EXPECT_FALSE(concepts::String<char*>);
@@ -102,6 +127,16 @@ TEST(Concepts, DictEntry)
     EXPECT_FALSE(concepts::DictEntry<non_pairlike2>);
 }
 
+TEST(Concepts, Struct)
+{
+    EXPECT_TRUE((concepts::Tuple<std::tuple<int, std::string>>));
+    EXPECT_TRUE((concepts::Tuple<std::pair<non_dict_s, double>>));
+    EXPECT_TRUE((concepts::Tuple<std::pair<int, double>>));
+    EXPECT_FALSE((concepts::Tuple<std::array<int, 2>>));
+    EXPECT_TRUE(concepts::Struct<struct_s>);
+    EXPECT_FALSE(concepts::Struct<non_dict_s>);
+}
+
 TEST(Concepts, Array)
 {
     EXPECT_TRUE(concepts::Container<std::vector<int>>);
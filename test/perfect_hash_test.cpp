@@ -0,0 +1,70 @@
+#include <sdbus/perfect_hash.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace sdbus;
+
+static constexpr std::array<std::string_view, 128> many_keys = {
+    "Property0", "Property1", "Property2", "Property3", "Property4", "Property5",
+    "Property6", "Property7", "Property8", "Property9", "Property10", "Property11",
+    "Property12", "Property13", "Property14", "Property15", "Property16", "Property17",
+    "Property18", "Property19", "Property20", "Property21", "Property22", "Property23",
+    "Property24", "Property25", "Property26", "Property27", "Property28", "Property29",
+    "Property30", "Property31", "Property32", "Property33", "Property34", "Property35",
+    "Property36", "Property37", "Property38", "Property39", "Property40", "Property41",
+    "Property42", "Property43", "Property44", "Property45", "Property46", "Property47",
+    "Property48", "Property49", "Property50", "Property51", "Property52", "Property53",
+    "Property54", "Property55", "Property56", "Property57", "Property58", "Property59",
+    "Property60", "Property61", "Property62", "Property63", "Property64", "Property65",
+    "Property66", "Property67", "Property68", "Property69", "Property70", "Property71",
+    "Property72", "Property73", "Property74", "Property75", "Property76", "Property77",
+    "Property78", "Property79", "Property80", "Property81", "Property82", "Property83",
+    "Property84", "Property85", "Property86", "Property87", "Property88", "Property89",
+    "Property90", "Property91", "Property92", "Property93", "Property94", "Property95",
+    "Property96", "Property97", "Property98", "Property99", "Property100", "Property101",
+    "Property102", "Property103", "Property104", "Property105", "Property106", "Property107",
+    "Property108", "Property109", "Property110", "Property111", "Property112", "Property113",
+    "Property114", "Property115", "Property116", "Property117", "Property118", "Property119",
+    "Property120", "Property121", "Property122", "Property123", "Property124", "Property125",
+    "Property126", "Property127",
+};
+
+static constexpr auto many = perfect_hash<many_keys.size()>(many_keys);
+
+TEST(PerfectHash, Lookup)
+{
+    static constexpr std::array<std::string_view, 4> keys = {"Running", "Degraded", "Stopped", ""};
+    static constexpr auto h = perfect_hash<keys.size()>(keys);
+
+    static_assert(h.valid());
+    static_assert(h.unique());
+    static_assert(h.find("Degraded") == 1);
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        EXPECT_EQ(h.find(keys[i]), i);
+    }
+    EXPECT_EQ(h.find("Runnin"), keys.size());
+    EXPECT_EQ(h.find("Running "), keys.size());
+    EXPECT_EQ(h.find("running"), keys.size());
+}
+
+TEST(PerfectHash, ManyKeys)
+{
+    static_assert(many.valid());
+
+    for (size_t i = 0; i < many_keys.size(); ++i)
+    {
+        EXPECT_EQ(many.find(many_keys[i]), i);
+    }
+    EXPECT_EQ(many.find("Property128"), many_keys.size());
+}
+
+TEST(PerfectHash, Duplicates)
+{
+    static constexpr std::array<std::string_view, 3> keys = {"a", "b", "a"};
+    static constexpr auto h = perfect_hash<keys.size()>(keys);
+
+    static_assert(!h.valid());
+    static_assert(!h.unique());
+}
@@ -1,8 +1,56 @@
 
+#include <sdbus/arena.hpp>
+#include <sdbus/borrowed.hpp>
+#include <sdbus/call.hpp>
+#include <sdbus/fd.hpp>
+#include <sdbus/intern.hpp>
 #include <sdbus/sdbus.hpp>
 
+#include <boost/container/flat_map.hpp>
+#include <boost/container/flat_set.hpp>
+
 #include <gtest/gtest.h>
 
+#include <array>
+#include <deque>
+#include <map>
+#include <memory_resource>
+#include <numeric>
+#include <ranges>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+#if __has_include(<generator>)
+#include <generator>
+#endif
+
+/*
+ * Counts the allocations that reach it, to check that a read leaves a
+ * container's memory alone.
+ */
+struct counting_resource : std::pmr::memory_resource
+{
+    size_t allocs = 0;
+
+  private:
+    void* do_allocate(size_t bytes, size_t align) override
+    {
+        ++allocs;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t align) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
 static constexpr auto sig(auto v)
 {
     return sdbus::traits<decltype(v)>::sig;
@@ -69,6 +117,11 @@ struct ReadWrite : public testing::Test
         return _msg.get();
     }
 
+    sd_bus* bus() const
+    {
+        return s_bus.get();
+    }
+
   private:
     static inline sdbus_ptr s_bus;
     sdbus_msg _msg;
@@ -204,3 +257,1008 @@ TEST_F(ReadWrite, AsBasic)
     EXPECT_TRUE(sdbus::read(ctx, d) == sdbus::errc::success);
     EXPECT_EQ(d, 505);
 }
+
+TEST_F(ReadWrite, BasicArrays)
+{
+    sdbus::defctx ctx(msg());
+
+    std::vector<uint32_t> u = {1, 2, 3, 0xFFFFFFFF}, u2;
+    std::vector<double> d = {1.5, -2.5}, d2 = {0.5};
+    std::array<int16_t, 3> n = {-1, 2, -3}, n2 = {};
+    std::vector<uint8_t> y, y2;
+    std::array<uint8_t, 2> small = {};
+    const uint64_t raw[] = {7, 8, 9};
+
+    EXPECT_EQ(sig(u), "au");
+    EXPECT_EQ(sig(n), "an");
+    EXPECT_EQ(sig(std::span<const uint64_t>(raw)), "at");
+
+    EXPECT_TRUE(sdbus::write(ctx, u) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, d) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, n) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, y) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, std::span<const uint64_t>(raw)) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, std::vector<uint8_t>{1, 2, 3}) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, u2) == sdbus::errc::success);
+    EXPECT_EQ(u, u2);
+    // reading into a non-empty vector appends, as the per-element path does
+    EXPECT_TRUE(sdbus::read(ctx, d2) == sdbus::errc::success);
+    EXPECT_EQ(d2, (std::vector<double>{0.5, 1.5, -2.5}));
+    EXPECT_TRUE(sdbus::read(ctx, n2) == sdbus::errc::success);
+    EXPECT_EQ(n, n2);
+    EXPECT_TRUE(sdbus::read(ctx, y2) == sdbus::errc::success);
+    EXPECT_TRUE(y2.empty());
+
+    std::vector<uint64_t> t;
+    EXPECT_TRUE(sdbus::read(ctx, t) == sdbus::errc::success);
+    EXPECT_EQ(t, (std::vector<uint64_t>{7, 8, 9}));
+
+    EXPECT_TRUE(sdbus::read(ctx, small) == sdbus::errc::out_of_space);
+}
+
+TEST_F(ReadWrite, AsArrayOf)
+{
+    sdbus::defctx ctx(msg());
+
+    std::vector<int> v = {1, 2, 300}, v2;
+    std::vector<bool> b = {true, false, true}, b2;
+
+    EXPECT_EQ(sig(sdbus::as_array_of<uint8_t>(v)), "ay");
+    EXPECT_EQ(sig(b), "ab");
+
+    EXPECT_TRUE(sdbus::write(ctx, sdbus::as_array_of<uint8_t>(v)) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, b) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, sdbus::as_array_of<uint8_t>(v2)) == sdbus::errc::success);
+    EXPECT_EQ(v2, (std::vector<int>{1, 2, 44}));
+    EXPECT_TRUE(sdbus::read(ctx, b2) == sdbus::errc::success);
+    EXPECT_EQ(b, b2);
+}
+
+TEST_F(ReadWrite, BorrowedViews)
+{
+    sdbus::defctx ctx(msg());
+
+    std::vector<uint8_t> y = {1, 2, 3, 4};
+    std::vector<std::string> as = {"first", "second"};
+
+    EXPECT_EQ(sig(std::span<const uint8_t>()), "ay");
+    EXPECT_EQ(sig(sdbus::borrowed<std::string_view>()), "s");
+
+    EXPECT_TRUE(sdbus::write(ctx, y) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, as) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, "text") == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, y) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    std::span<const uint8_t> y2;
+    std::vector<std::string_view> as2;
+    sdbus::borrowed<std::string_view> s2;
+    sdbus::borrowed<std::span<const uint8_t>> y3;
+
+    EXPECT_TRUE(sdbus::read(ctx, y2) == sdbus::errc::success);
+    EXPECT_TRUE(std::ranges::equal(y, y2));
+    EXPECT_NE(y.data(), y2.data());
+    EXPECT_TRUE(sdbus::read(ctx, as2) == sdbus::errc::success);
+    EXPECT_TRUE(std::ranges::equal(as, as2));
+    EXPECT_TRUE(sdbus::read(ctx, s2) == sdbus::errc::success);
+    EXPECT_EQ(*s2, "text");
+    EXPECT_EQ(static_cast<sd_bus_message*>(s2.owner), msg());
+    EXPECT_TRUE(sdbus::read(ctx, y3) == sdbus::errc::success);
+    EXPECT_TRUE(std::ranges::equal(y, *y3));
+    EXPECT_NE(y3->data(), y2.data());
+}
+
+struct dict_s
+{
+    int32_t a;
+    std::string b;
+    std::vector<uint32_t> c;
+
+    using dict_t = std::tuple<sdbus::property<"a", &dict_s::a>, sdbus::property<"b", &dict_s::b>,
+                              sdbus::property<"c", &dict_s::c>>;
+};
+
+struct pmr_dict_s
+{
+    int32_t a;
+    std::pmr::string b;
+    std::pmr::vector<uint32_t> c;
+
+    using dict_t =
+        std::tuple<sdbus::property<"a", &pmr_dict_s::a>, sdbus::property<"b", &pmr_dict_s::b>,
+                   sdbus::property<"c", &pmr_dict_s::c>>;
+};
+
+TEST_F(ReadWrite, NestedContainers)
+{
+    sdbus::defctx ctx(msg());
+
+    using value_t = std::variant<int32_t, std::string>;
+    std::map<std::string, std::vector<value_t>> m = {
+        {"one", {1, "two"}},
+        {"three", {}},
+        {"four", {"five", 6, 7}},
+    };
+    decltype(m) m2;
+    dict_s d = {-1, "text", {1, 2}}, d2 = {};
+
+    EXPECT_EQ(sig(m), "a{sav}");
+    EXPECT_EQ(sig(d), "a{sv}");
+
+    EXPECT_TRUE(sdbus::write(ctx, m) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, d) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, m2) == sdbus::errc::success);
+    EXPECT_EQ(m, m2);
+    EXPECT_TRUE(sdbus::read(ctx, d2) == sdbus::errc::success);
+    EXPECT_EQ(d.a, d2.a);
+    EXPECT_EQ(d.b, d2.b);
+    EXPECT_EQ(d.c, d2.c);
+}
+
+TEST_F(ReadWrite, DictLookup)
+{
+    sdbus::defctx ctx(msg());
+
+    using value_t = std::variant<int32_t, std::string, std::vector<uint32_t>>;
+    std::vector<std::pair<std::string, value_t>> props = {
+        {"c", std::vector<uint32_t>{3, 4}},
+        {"unknown", "skipped"},
+        {"a", 5},
+        {"b", "text"},
+    };
+    dict_s d = {};
+
+    EXPECT_EQ(sig(props), "a{sv}");
+    EXPECT_TRUE(sdbus::write(ctx, props) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, d) == sdbus::errc::success);
+    EXPECT_EQ(d.a, 5);
+    EXPECT_EQ(d.b, "text");
+    EXPECT_EQ(d.c, (std::vector<uint32_t>{3, 4}));
+    EXPECT_EQ(sdbus::property_table<dict_s>::find("b"), &sdbus::property_table<dict_s>::descs[1]);
+    EXPECT_EQ(sdbus::property_table<dict_s>::find("d"), nullptr);
+}
+
+TEST_F(ReadWrite, VariantDispatch)
+{
+    sdbus::defctx ctx(msg());
+
+    using value_t = std::variant<bool, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t,
+                                 uint64_t, double, std::string, std::vector<std::string>,
+                                 std::vector<uint32_t>, std::map<std::string, int32_t>>;
+    using index_t = sdbus::variant_index<value_t>;
+    std::vector<value_t> v = {
+        true, uint8_t(1), int16_t(-2), uint16_t(3), int32_t(-4), uint32_t(5), int64_t(-6),
+        uint64_t(7), 8.5, "nine", std::vector<std::string>{"ten"}, std::vector<uint32_t>{11, 12},
+        std::map<std::string, int32_t>{{"thirteen", 13}},
+    };
+    std::vector<value_t> v2;
+    std::variant<int32_t, std::string> bad;
+
+    EXPECT_EQ(index_t::find("u"), 5u);
+    EXPECT_EQ(index_t::find("au"), 11u);
+    EXPECT_EQ(index_t::find("a{si}"), 12u);
+    EXPECT_EQ(index_t::find("ai"), index_t::npos);
+    EXPECT_EQ(index_t::find(""), index_t::npos);
+
+    EXPECT_TRUE(sdbus::write(ctx, v) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, v[8]) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, v2) == sdbus::errc::success);
+    EXPECT_EQ(v, v2);
+    EXPECT_TRUE(sdbus::read(ctx, bad) == sdbus::errc::bad_variant);
+}
+
+TEST_F(ReadWrite, VariantReuse)
+{
+    sdbus::defctx ctx(msg());
+
+    using value_t = std::variant<int32_t, std::string, std::vector<uint32_t>>;
+    std::vector<value_t> v = {std::vector<uint32_t>{1, 2, 3}, std::vector<uint32_t>{4, 5}, 6};
+    value_t v2 = std::vector<uint32_t>(8);
+    auto data = std::get<2>(v2).data();
+
+    for (const auto& i : v)
+    {
+        EXPECT_TRUE(sdbus::write(ctx, i) == sdbus::errc::success);
+    }
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, v2) == sdbus::errc::success);
+    EXPECT_EQ(v2, v[0]);
+    EXPECT_EQ(std::get<2>(v2).data(), data);
+    EXPECT_TRUE(sdbus::read(ctx, v2) == sdbus::errc::success);
+    EXPECT_EQ(v2, v[1]);
+    EXPECT_EQ(std::get<2>(v2).data(), data);
+    EXPECT_TRUE(sdbus::read(ctx, v2) == sdbus::errc::success);
+    EXPECT_EQ(v2, v[2]);
+}
+
+TEST_F(ReadWrite, ReadReuse)
+{
+    sdbus::defctx ctx(msg());
+    counting_resource counter;
+
+    using string_t = std::pmr::string;
+    using value_t = std::variant<int32_t, string_t, std::pmr::vector<uint32_t>>;
+    std::pmr::vector<string_t> v = {"a string long enough to live on the heap",
+                                    "and another one"};
+    std::pmr::map<string_t, value_t> m = {
+        {"a key long enough to live on the heap", "a value long enough to live on the heap"},
+        {"another key long enough to live on the heap", std::pmr::vector<uint32_t>{1, 2, 3}},
+    };
+    std::pmr::set<string_t> s = {"one", "two"};
+    pmr_dict_s d = {1, "a text long enough to live on the heap", {1, 2, 3}};
+    decltype(v) v2(&counter), v3 = {v[0]};
+    decltype(m) m2(&counter), m3 = {*m.begin()};
+    decltype(s) s2(&counter), s3 = {"three"};
+    pmr_dict_s d2 = {0, string_t(&counter), std::pmr::vector<uint32_t>(&counter)};
+    pmr_dict_s d3 = {2, "short", {}};
+
+    auto write = [&](const auto&... args) {
+        return ((sdbus::write(ctx, args) == sdbus::errc::success) && ...);
+    };
+    auto read = [&](auto&... args) {
+        return ((sdbus::read(ctx, args) == sdbus::errc::success) && ...);
+    };
+
+    EXPECT_TRUE(write(v, m, s, d));
+    EXPECT_TRUE(write(v, m, s, d));
+    EXPECT_TRUE(write(v3, m3, s3, d3));
+
+    sd_bus_message_seal(msg(), 100, 0);
+    ctx.set_reuse(true);
+
+    EXPECT_TRUE(read(v2, m2, s2, d2));
+    EXPECT_EQ(v2, v);
+    EXPECT_EQ(m2, m);
+
+    auto allocs = counter.allocs;
+    EXPECT_TRUE(read(v2, m2, s2, d2));
+    EXPECT_EQ(counter.allocs, allocs);
+    EXPECT_EQ(v2, v);
+    EXPECT_EQ(m2, m);
+    EXPECT_EQ(s2, s);
+    EXPECT_EQ(d2.b, d.b);
+    EXPECT_EQ(d2.c, d.c);
+
+    EXPECT_TRUE(read(v2, m2, s2, d2));
+    EXPECT_EQ(v2, v3);
+    EXPECT_EQ(m2, m3);
+    EXPECT_EQ(s2, s3);
+    EXPECT_EQ(d2.a, d3.a);
+    EXPECT_EQ(d2.b, d3.b);
+    EXPECT_EQ(d2.c, d3.c);
+}
+
+TEST_F(ReadWrite, PresizedContainers)
+{
+    sdbus::defctx ctx(msg());
+
+    std::vector<std::string> v;
+    std::unordered_map<std::string, uint32_t> m;
+    std::vector<std::vector<std::string>> n = {{"one", "two", "three"}, {}, {"four"}};
+    std::unordered_set<uint32_t> s;
+    std::deque<int32_t> d;
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        v.push_back(std::to_string(i));
+        m.emplace(std::to_string(i), i);
+        s.insert(i);
+        d.push_back(-static_cast<int32_t>(i));
+    }
+    decltype(v) v2 = {"keep"};
+    decltype(m) m2;
+    decltype(n) n2;
+    decltype(s) s2;
+    decltype(d) d2;
+
+    EXPECT_TRUE(sdbus::write(ctx, v) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, m) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, n) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, s) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, d) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, sdbus::presized(v2)) == sdbus::errc::success);
+    EXPECT_EQ(v2.size(), 101u);
+    EXPECT_EQ(v2.capacity(), 101u);
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), v2.begin() + 1));
+    EXPECT_TRUE(sdbus::read(ctx, sdbus::presized(m2)) == sdbus::errc::success);
+    EXPECT_EQ(m, m2);
+    EXPECT_TRUE(sdbus::read(ctx, sdbus::presized(n2)) == sdbus::errc::success);
+    EXPECT_EQ(n, n2);
+    EXPECT_EQ(n2.capacity(), 3u);
+
+    decltype(s) reserved;
+    reserved.reserve(100);
+    EXPECT_TRUE(sdbus::read(ctx, s2) == sdbus::errc::success);
+    EXPECT_EQ(s, s2);
+    EXPECT_EQ(s2.bucket_count(), reserved.bucket_count());
+    EXPECT_TRUE(sdbus::read(ctx, d2) == sdbus::errc::success);
+    EXPECT_EQ(d, d2);
+}
+
+TEST_F(ReadWrite, ArenaAllocation)
+{
+    sdbus::defctx ctx(msg());
+
+    using value_t = std::variant<int32_t, std::string>;
+    std::vector<std::string> v = {"a string long enough to live on the heap", "another"};
+    std::map<std::string, value_t> m = {
+        {"a key long enough to live on the heap", "a value long enough to live on the heap"},
+        {"b", 2},
+    };
+
+    EXPECT_TRUE(sdbus::write(ctx, v) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, m) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    using pmr_value_t = std::variant<int32_t, std::pmr::string>;
+    sdbus::arena<> mem(std::pmr::null_memory_resource());
+    auto v2 = mem.make<std::pmr::vector<std::pmr::string>>();
+    auto m2 = mem.make<std::pmr::map<std::pmr::string, pmr_value_t>>();
+
+    counting_resource fallback;
+    auto prev = std::pmr::set_default_resource(&fallback);
+    EXPECT_TRUE(sdbus::read(msg(), mem, v2) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::read(msg(), mem, m2) == sdbus::errc::success);
+    std::pmr::set_default_resource(prev);
+    EXPECT_EQ(fallback.allocs, 0u);
+
+    EXPECT_EQ(v2.size(), v.size());
+    EXPECT_EQ(std::string_view(v2[0]), v[0]);
+    EXPECT_EQ(std::string_view(v2[1]), v[1]);
+    EXPECT_EQ(v2[0].get_allocator().resource(), &mem);
+    EXPECT_EQ(m2.size(), 2u);
+    auto& s = std::get<1>(m2.begin()->second);
+    EXPECT_EQ(std::string_view(s), std::get<1>(m.begin()->second));
+    EXPECT_EQ(s.get_allocator().resource(), &mem);
+    EXPECT_EQ(std::get<0>(m2.rbegin()->second), 2);
+
+    sd_bus_message_rewind(msg(), 1);
+    sdbus::defctx reuse(msg());
+    reuse.set_reuse(true);
+    reuse.set_resource(&mem);
+    EXPECT_TRUE(sdbus::read(reuse, v2) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::read(reuse, m2) == sdbus::errc::success);
+    EXPECT_EQ(m2.get_allocator().resource(), &mem);
+    EXPECT_EQ(m2.size(), 2u);
+    EXPECT_EQ(std::get<1>(m2.begin()->second).get_allocator().resource(), &mem);
+}
+
+TEST_F(ReadWrite, ErrorPolicies)
+{
+    sdbus::defctx ctx(msg());
+
+    std::vector<std::string> v = {"one", "two", "three"};
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(sdbus::write(ctx, v) == sdbus::errc::success);
+    }
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    using sdbus::error_policy;
+    std::array<std::string, 2> a;
+    sdbus::context<error_policy::fail_fast> fail_fast(msg());
+    sdbus::context<error_policy::skip> skip(msg());
+    sdbus::context<error_policy::collect> collect(msg());
+    sdbus::defctx dynamic(msg(), [](const sdbus::subctx& ctx, sdbus::errc ec) {
+        return ctx.index() == 2 ? sdbus::errc::success : ec;
+    });
+
+    auto policy_of = [](const sdbus::subctx& ctx) {
+        return ctx.with_policy([]<typename P>(P) {
+            return P::on_error == sdbus::element_policy::fail ? sdbus::errc::success
+                                                               : sdbus::errc::invalid_type;
+        });
+    };
+    EXPECT_TRUE(policy_of(fail_fast) == sdbus::errc::success);
+    EXPECT_TRUE(policy_of(skip) == sdbus::errc::invalid_type);
+    EXPECT_TRUE(skip.with_policy([]<typename P>(P) {
+        return !P::track_path && P::on_error == sdbus::element_policy::handle
+                   ? sdbus::errc::success
+                   : sdbus::errc::invalid_type;
+    }) == sdbus::errc::success);
+    EXPECT_TRUE(collect.with_path_tracking([]<bool TrackPath>(std::bool_constant<TrackPath>) {
+        return TrackPath ? sdbus::errc::success : sdbus::errc::invalid_type;
+    }) == sdbus::errc::success);
+
+    EXPECT_TRUE(sdbus::read(fail_fast, a) == sdbus::errc::out_of_space);
+    a = {};
+    EXPECT_TRUE(sdbus::read(skip, a) == sdbus::errc::success);
+    EXPECT_EQ(a, (std::array<std::string, 2>{"one", "two"}));
+    a = {};
+    EXPECT_TRUE(sdbus::read(collect, a) == sdbus::errc::success);
+    EXPECT_EQ(a, (std::array<std::string, 2>{"one", "two"}));
+    ASSERT_EQ(collect.errors().size(), 1u);
+    EXPECT_EQ(collect.errors()[0].path, "<top>/2");
+    EXPECT_TRUE(collect.errors()[0].ec == sdbus::errc::out_of_space);
+    a = {};
+    EXPECT_TRUE(sdbus::read(dynamic, a) == sdbus::errc::success);
+    EXPECT_EQ(a, (std::array<std::string, 2>{"one", "two"}));
+}
+
+TEST_F(ReadWrite, Projection)
+{
+    sdbus::defctx ctx(msg());
+
+    dict_s d = {1, "a text long enough to live on the heap", {1, 2, 3}};
+    for (int i = 0; i < 2; ++i)
+    {
+        EXPECT_TRUE(sdbus::write(ctx, d) == sdbus::errc::success);
+    }
+    EXPECT_TRUE(sdbus::write(ctx, d.b) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, d.c) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, d.a) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    counting_resource counter;
+    pmr_dict_s d2 = {0, std::pmr::string(&counter), std::pmr::vector<uint32_t>(&counter)};
+    dict_s d3 = {};
+    EXPECT_TRUE(sdbus::read(ctx, sdbus::project<"a">(d2)) == sdbus::errc::success);
+    EXPECT_EQ(counter.allocs, 0u);
+    EXPECT_EQ(d2.a, d.a);
+    EXPECT_TRUE(d2.b.empty());
+    EXPECT_TRUE(d2.c.empty());
+
+    sdbus::property_mask<dict_s> mask;
+    mask.set(sdbus::property_table<dict_s>::index_of(sdbus::property_table<dict_s>::find("c")));
+    EXPECT_TRUE(sdbus::read(ctx, sdbus::project(d3, mask)) == sdbus::errc::success);
+    EXPECT_EQ(d3.a, 0);
+    EXPECT_TRUE(d3.b.empty());
+    EXPECT_EQ(d3.c, d.c);
+
+    int32_t a = 0;
+    EXPECT_TRUE(sdbus::read_arg(msg(), 4, a) == sdbus::errc::success);
+    EXPECT_EQ(a, d.a);
+    std::string b;
+    EXPECT_TRUE(sdbus::read_arg(msg(), 2, b) == sdbus::errc::success);
+    EXPECT_EQ(b, d.b);
+    EXPECT_TRUE(sdbus::read_arg(msg(), 5, a) == sdbus::errc::read_error);
+}
+
+TEST_F(ReadWrite, ArgumentLists)
+{
+    sdbus::message m(msg());
+
+    using args_t = std::tuple<int32_t, uint8_t, bool, double, uint64_t, int16_t, std::string,
+                              std::vector<uint32_t>, uint32_t>;
+    args_t args = {-1, 2, true, 3.5, 4, -5, "six", {7, 8}, 9};
+
+    using list_t = sdbus::arg_list<int32_t, bool, std::string, int32_t>;
+    EXPECT_EQ(list_t::basic_size, 2u);
+    EXPECT_EQ(list_t::basic_sig, "ib");
+    EXPECT_EQ(list_t::sig, "ibsi");
+
+    std::apply([&](const auto&... v) { m.append_all(v...); }, args);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_STREQ(m.get_signature(), "iybdtnsauu");
+    int32_t i;
+    std::string s;
+    EXPECT_TRUE(sdbus::read_all(msg(), i, s) == sdbus::errc::invalid_type);
+    EXPECT_EQ((m.read_all<int32_t, uint8_t, bool, double, uint64_t, int16_t, std::string,
+                          std::vector<uint32_t>, uint32_t>()),
+              args);
+}
+
+enum class state
+{
+    running,
+    degraded,
+    failed,
+};
+
+enum class level : uint8_t
+{
+    low,
+    high,
+};
+
+template <>
+struct sdbus::traits<state> : sdbus::enum_string_traits<state, "Running", "Degraded", "Failed">
+{};
+
+TEST_F(ReadWrite, Enums)
+{
+    sdbus::defctx ctx(msg());
+
+    std::vector<state> v = {state::failed, state::running, state::degraded};
+    std::vector<state> v2;
+    level l = level::high, l2 = level::low;
+    state s;
+
+    EXPECT_EQ(sig(v), "as");
+    EXPECT_EQ(sig(l), "y");
+
+    EXPECT_TRUE(sdbus::write(ctx, v) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, l) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, "Stopped") == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, static_cast<state>(3)) == sdbus::errc::invalid_enum);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, v2) == sdbus::errc::success);
+    EXPECT_EQ(v2, v);
+    EXPECT_TRUE(sdbus::read(ctx, l2) == sdbus::errc::success);
+    EXPECT_EQ(l2, l);
+    EXPECT_TRUE(sdbus::read(ctx, s) == sdbus::errc::invalid_enum_string);
+}
+
+TEST_F(ReadWrite, DirtyTracking)
+{
+    sdbus::defctx ctx(msg());
+
+    sdbus::tracked<dict_s> t({1, "text", {1, 2}});
+    t.set<"a">(1);
+    t.set<"b">("changed");
+    EXPECT_EQ(t.dirty(), sdbus::property_mask<dict_s>(0b010));
+
+    dict_s next = t.value();
+    next.c = {3};
+    t.update(next);
+    EXPECT_EQ(t.dirty(), sdbus::property_mask<dict_s>(0b110));
+    EXPECT_EQ(sdbus::changed(next, t.value()), sdbus::property_mask<dict_s>());
+
+    EXPECT_TRUE(sdbus::write(ctx, t.changes()) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, sdbus::property_names<dict_s>{t.dirty()}) ==
+                sdbus::errc::success);
+    t.clear();
+    EXPECT_TRUE(sdbus::write(ctx, t.changes()) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    std::map<std::string, std::variant<int32_t, std::string, std::vector<uint32_t>>> m;
+    std::vector<std::string> names;
+    EXPECT_TRUE(sdbus::read(ctx, m) == sdbus::errc::success);
+    EXPECT_EQ(m.size(), 2u);
+    EXPECT_EQ(std::get<std::string>(m["b"]), "changed");
+    EXPECT_EQ(std::get<std::vector<uint32_t>>(m["c"]), (std::vector<uint32_t>{3}));
+    EXPECT_TRUE(sdbus::read(ctx, names) == sdbus::errc::success);
+    EXPECT_EQ(names, (std::vector<std::string>{"b", "c"}));
+    m.clear();
+    EXPECT_TRUE(sdbus::read(ctx, m) == sdbus::errc::success);
+    EXPECT_TRUE(m.empty());
+}
+
+TEST_F(ReadWrite, PreparedMessages)
+{
+    using call_t = sdbus::prepared_call<"org.example.Service", "/org/example/object",
+                                        "org.example.Interface", "Set", int32_t, std::string>;
+    using signal_t =
+        sdbus::prepared_signal<"/org/example/object", "org.example.Interface", "Changed", bool>;
+
+    EXPECT_TRUE(sdbus::valid_bus_name(":1.42"));
+    EXPECT_TRUE(sdbus::valid_bus_name("org.example-1.Service"));
+    EXPECT_FALSE(sdbus::valid_bus_name("org"));
+    EXPECT_FALSE(sdbus::valid_bus_name("org.1example"));
+    EXPECT_TRUE(sdbus::valid_object_path("/"));
+    EXPECT_FALSE(sdbus::valid_object_path("/org/"));
+    EXPECT_FALSE(sdbus::valid_object_path("/org//example"));
+    EXPECT_FALSE(sdbus::valid_interface_name("org..example"));
+    EXPECT_FALSE(sdbus::valid_member_name("1st"));
+    EXPECT_EQ(call_t::sig, "is");
+
+    auto call = call_t::create(bus(), 5, "text");
+    auto signal = signal_t::create(bus(), true);
+
+    EXPECT_STREQ(sd_bus_message_get_destination(call), "org.example.Service");
+    EXPECT_STREQ(sd_bus_message_get_path(call), "/org/example/object");
+    EXPECT_STREQ(sd_bus_message_get_interface(call), "org.example.Interface");
+    EXPECT_STREQ(sd_bus_message_get_member(call), "Set");
+    EXPECT_STREQ(sd_bus_message_get_member(signal), "Changed");
+
+    sd_bus_message_seal(call, 100, 0);
+    sd_bus_message_seal(signal, 101, 0);
+
+    EXPECT_EQ((call.read_all<int32_t, std::string>()), (std::tuple<int32_t, std::string>{5, "text"}));
+    EXPECT_EQ(signal.read_all<bool>(), std::tuple<bool>{true});
+}
+
+TEST_F(ReadWrite, FileDescriptors)
+{
+    sdbus::defctx ctx(msg());
+
+    std::vector<uint8_t> blob(1 << 20, 0x5a);
+    auto payload = sdbus::memfd_payload::create("blob", blob);
+    sdbus::unix_fd fd(::memfd_create("plain", MFD_CLOEXEC));
+    sdbus::memfd_payload received;
+    sdbus::unix_fd fd2;
+
+    EXPECT_EQ(sdbus::traits<sdbus::unix_fd>::sig, "h");
+    EXPECT_EQ(sdbus::traits<sdbus::memfd_payload>::sig, "h");
+    EXPECT_EQ(payload.size(), blob.size());
+
+    EXPECT_TRUE(sdbus::write(ctx, payload) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, fd) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, fd) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, received) == sdbus::errc::success);
+    EXPECT_TRUE(std::ranges::equal(received.data(), blob));
+    EXPECT_TRUE(sdbus::read(ctx, fd2) == sdbus::errc::success);
+    EXPECT_TRUE(fd2);
+    EXPECT_NE(fd2.get(), fd.get());
+
+    // Unsealed memfds could shrink under the mapping, so they are refused.
+    EXPECT_TRUE(sdbus::read(ctx, received) == sdbus::errc::invalid_type);
+    EXPECT_FALSE(received.fd());
+    EXPECT_EQ(received.size(), 0);
+}
+
+TEST_F(ReadWrite, Emplacement)
+{
+    sdbus::defctx ctx(msg());
+
+    std::string_view fragment = std::string_view("unterminated").substr(0, 5);
+    auto number = sdbus::emplace_string(3, [](std::span<char> buf) { std::ranges::fill(buf, '7'); });
+    auto squares = sdbus::emplace_array<uint32_t>(4, [](std::span<uint32_t> buf) {
+        for (uint32_t i = 0; i < buf.size(); ++i)
+        {
+            buf[i] = i * i;
+        }
+    });
+    std::string s1, s2, s3;
+    std::vector<uint32_t> v;
+
+    EXPECT_EQ(sig(number), "s");
+    EXPECT_EQ(sig(squares), "au");
+    EXPECT_EQ(sig(sdbus::concat("a", fragment)), "s");
+
+    EXPECT_TRUE(sdbus::write(ctx, number) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, squares) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, sdbus::concat("/", fragment, std::string("/x"))) ==
+                sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, fragment) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, s1) == sdbus::errc::success);
+    EXPECT_EQ(s1, "777");
+    EXPECT_TRUE(sdbus::read(ctx, v) == sdbus::errc::success);
+    EXPECT_EQ(v, (std::vector<uint32_t>{0, 1, 4, 9}));
+    EXPECT_TRUE(sdbus::read(ctx, s2) == sdbus::errc::success);
+    EXPECT_EQ(s2, "/unter/x");
+    EXPECT_TRUE(sdbus::read(ctx, s3) == sdbus::errc::success);
+    EXPECT_EQ(s3, "unter");
+}
+
+TEST_F(ReadWrite, ArrayRange)
+{
+    sdbus::defctx ctx(msg());
+
+    std::vector<int32_t> v(1000);
+    std::iota(v.begin(), v.end(), 0);
+    std::map<std::string, int32_t> m{{"a", 1}, {"b", 2}, {"c", 3}};
+
+    EXPECT_TRUE(sdbus::write(ctx, v) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, m) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, v) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, "tail") == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    sdbus::message message(msg());
+    std::vector<int32_t> picked;
+    auto multiples = std::views::filter([](int32_t i) { return i % 7 == 0; });
+    for (auto i : message.range<int32_t>() | multiples)
+    {
+        if (i > 30)
+        {
+            break;
+        }
+        picked.push_back(i);
+    }
+    EXPECT_EQ(picked, (std::vector<int32_t>{0, 7, 14, 21, 28}));
+
+    std::vector<std::string> keys;
+    for (auto& [k, n] : message.range<std::pair<std::string, int32_t>>())
+    {
+        keys.push_back(k);
+    }
+    EXPECT_EQ(keys, (std::vector<std::string>{"a", "b", "c"}));
+
+    auto r = message.range<int32_t>();
+    auto taken = std::move(r);
+    EXPECT_TRUE(r.begin() == r.end());
+    taken.close();
+    EXPECT_TRUE(taken.begin() == taken.end());
+
+    EXPECT_EQ(message.read<std::string>(), "tail");
+}
+
+TEST_F(ReadWrite, RangeWrite)
+{
+    sdbus::defctx ctx(msg());
+
+    std::vector<int32_t> v{1, 2, 3, 4, 5, 6};
+    std::map<std::string, int32_t> m{{"a", 1}, {"b", 2}};
+    auto squares = std::views::iota(0, 4) | std::views::transform([](int i) { return i * i; });
+    auto even = v | std::views::filter([](int32_t i) { return i % 2 == 0; });
+    auto names = m | std::views::keys;
+    std::vector<int32_t> v2, v3;
+    std::vector<std::string> v4;
+
+    EXPECT_EQ(sig(squares), "ai");
+    EXPECT_EQ(sig(names), "as");
+
+    EXPECT_TRUE(sdbus::write(ctx, squares) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, even) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, names) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, v | std::views::filter([](int32_t i) { return i > 4; })) ==
+                sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, v2) == sdbus::errc::success);
+    EXPECT_EQ(v2, (std::vector<int32_t>{0, 1, 4, 9}));
+    EXPECT_TRUE(sdbus::read(ctx, v3) == sdbus::errc::success);
+    EXPECT_EQ(v3, (std::vector<int32_t>{2, 4, 6}));
+    EXPECT_TRUE(sdbus::read(ctx, v4) == sdbus::errc::success);
+    EXPECT_EQ(v4, (std::vector<std::string>{"a", "b"}));
+    v2.clear();
+    EXPECT_TRUE(sdbus::read(ctx, v2) == sdbus::errc::success);
+    EXPECT_EQ(v2, (std::vector<int32_t>{5, 6}));
+}
+
+#ifdef __cpp_lib_generator
+TEST_F(ReadWrite, GeneratorWrite)
+{
+    sdbus::defctx ctx(msg());
+
+    auto countdown = [](int32_t n) -> std::generator<std::string> {
+        while (n > 0)
+        {
+            co_yield std::to_string(n--);
+        }
+    };
+    auto g = countdown(3);
+    std::vector<std::string> v;
+
+    static_assert(sdbus::concepts::MutableRange<std::generator<std::string>>);
+    EXPECT_EQ(sdbus::traits<std::generator<std::string>>::sig, "as");
+
+    EXPECT_TRUE(sdbus::write(ctx, g) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, countdown(1)) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, v) == sdbus::errc::success);
+    EXPECT_EQ(v, (std::vector<std::string>{"3", "2", "1"}));
+    EXPECT_TRUE(sdbus::read(ctx, v) == sdbus::errc::success);
+    EXPECT_EQ(v, (std::vector<std::string>{"3", "2", "1", "1"}));
+}
+#endif
+
+TEST_F(ReadWrite, BulkConversions)
+{
+    sdbus::defctx ctx(msg());
+
+    std::vector<int32_t> v(1000);
+    std::iota(v.begin(), v.end(), -500);
+    std::vector<int> flags = {0, 2, 0, -1};
+    std::deque<bool> d = {false, true};
+    std::vector<int32_t> v2;
+    std::vector<bool> b2;
+    std::array<int64_t, 2> a2;
+
+    EXPECT_EQ(sig(sdbus::as_array_of<double>(v)), "ad");
+    EXPECT_EQ(sig(sdbus::as_array_of<bool>(flags)), "ab");
+    EXPECT_EQ(sig(d), "ab");
+
+    EXPECT_TRUE(sdbus::write(ctx, sdbus::as_array_of<double>(v)) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, sdbus::as_array_of<int16_t>(v)) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, sdbus::as_array_of<bool>(flags)) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, d) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, sdbus::as_array_of<double>(v2)) == sdbus::errc::success);
+    EXPECT_EQ(v2, v);
+    EXPECT_TRUE(sdbus::read(ctx, sdbus::as_array_of<int16_t>(a2)) == sdbus::errc::out_of_space);
+    EXPECT_TRUE(sdbus::read(ctx, b2) == sdbus::errc::success);
+    EXPECT_EQ(b2, (std::vector<bool>{false, true, false, true}));
+    EXPECT_TRUE(sdbus::read(ctx, b2) == sdbus::errc::success);
+    EXPECT_EQ(b2, (std::vector<bool>{false, true, false, true, false, true}));
+}
+
+TEST_F(ReadWrite, FlatContainers)
+{
+    sdbus::defctx ctx(msg());
+
+    std::vector<std::pair<std::string, int32_t>> unsorted{{"c", 3}, {"a", 1}, {"b", 2}, {"a", 4}};
+    std::map<std::string, int32_t> sorted{{"x", 1}, {"y", 2}};
+    std::vector<int32_t> numbers{5, 3, 5, 1};
+    boost::container::flat_map<std::string, int32_t> m1{{"b", 0}}, m2;
+    boost::container::flat_set<int32_t> s;
+    boost::container::flat_multiset<int32_t> ms;
+
+    EXPECT_EQ(sig(m1), "a{si}");
+
+    EXPECT_TRUE(sdbus::write(ctx, unsorted) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, sorted) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, numbers) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, numbers) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, m1) == sdbus::errc::success);
+    EXPECT_EQ(m1, (boost::container::flat_map<std::string, int32_t>{
+                      {"a", 1}, {"b", 0}, {"c", 3}}));
+    EXPECT_TRUE(sdbus::read(ctx, m2) == sdbus::errc::success);
+    EXPECT_EQ(m2, (boost::container::flat_map<std::string, int32_t>{{"x", 1}, {"y", 2}}));
+    EXPECT_TRUE(sdbus::read(ctx, s) == sdbus::errc::success);
+    EXPECT_EQ(s, (boost::container::flat_set<int32_t>{1, 3, 5}));
+    EXPECT_TRUE(sdbus::read(ctx, ms) == sdbus::errc::success);
+    EXPECT_EQ(ms, (boost::container::flat_multiset<int32_t>{1, 3, 5, 5}));
+}
+
+struct sample
+{
+    uint64_t time;
+    double min;
+    double max;
+
+    bool operator==(const sample&) const = default;
+};
+
+template <>
+struct sdbus::traits<sample> :
+    sdbus::struct_traits<sample, &sample::time, &sample::min, &sample::max>
+{};
+
+struct labeled
+{
+    std::string name;
+    std::vector<sample> samples;
+};
+
+template <>
+struct sdbus::traits<labeled> : sdbus::struct_traits<labeled, &labeled::name, &labeled::samples>
+{};
+
+TEST_F(ReadWrite, Structs)
+{
+    sdbus::defctx ctx(msg());
+
+    labeled l{"cpu", {{1, 0.5, 1.0}, {2, 0.25, 2.0}}};
+    std::vector<sample> v{{3, -1.0, 1.0}};
+    labeled l2;
+    std::vector<sample> v2;
+
+    EXPECT_EQ(sig(l), "(sa(tdd))");
+    EXPECT_EQ(sig(v), "a(tdd)");
+
+    EXPECT_TRUE(sdbus::write(ctx, l) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, v) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, l2) == sdbus::errc::success);
+    EXPECT_EQ(l2.name, "cpu");
+    EXPECT_EQ(l2.samples, l.samples);
+    EXPECT_TRUE(sdbus::read(ctx, v2) == sdbus::errc::success);
+    EXPECT_EQ(v2, v);
+}
+
+struct reading
+{
+    std::string sensor;
+    double value;
+    std::vector<std::tuple<uint8_t, bool>> flags;
+
+    using struct_t = sdbus::members<&reading::sensor, &reading::value, &reading::flags>;
+};
+
+TEST_F(ReadWrite, Tuples)
+{
+    sdbus::defctx ctx(msg());
+
+    std::tuple<int32_t, std::string, std::vector<double>> t{7, "seven", {7.0, 0.7}};
+    std::pair<std::vector<int32_t>, bool> p{{1, 2}, true};
+    std::pair<int32_t, std::string> e{3, "three"};
+    reading r{"temp", 21.5, {{1, true}, {2, false}}};
+    decltype(t) t2;
+    decltype(p) p2;
+    decltype(e) e2;
+    reading r2;
+
+    EXPECT_EQ(sig(e), "(is)");
+    EXPECT_EQ(sig(r), "(sda(yb))");
+
+    EXPECT_TRUE(sdbus::write(ctx, t) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, p) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, e) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, r) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    EXPECT_TRUE(sdbus::read(ctx, t2) == sdbus::errc::success);
+    EXPECT_EQ(t2, t);
+    EXPECT_TRUE(sdbus::read(ctx, p2) == sdbus::errc::success);
+    EXPECT_EQ(p2, p);
+    EXPECT_TRUE(sdbus::read(ctx, e2) == sdbus::errc::success);
+    EXPECT_EQ(e2, e);
+    EXPECT_TRUE(sdbus::read(ctx, r2) == sdbus::errc::success);
+    EXPECT_EQ(r2.sensor, "temp");
+    EXPECT_EQ(r2.value, 21.5);
+    EXPECT_EQ(r2.flags, r.flags);
+}
+
+TEST_F(ReadWrite, InternedStrings)
+{
+    sdbus::defctx ctx(msg());
+
+    std::vector<std::string> names{"org.example.Sensor", "org.example.Sensor"};
+    std::unordered_map<std::string, int32_t> m{{"Value", 1}, {"Unit", 2}};
+    sdbus::interned_objpath path;
+    std::unordered_map<sdbus::interned_string, int32_t> m2;
+
+    EXPECT_EQ(sig(path), "o");
+    EXPECT_EQ(sig(m2), "a{si}");
+
+    EXPECT_TRUE(sdbus::write(ctx, names) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, sdbus::objpath("/org/example/sensor0")) == sdbus::errc::success);
+    EXPECT_TRUE(sdbus::write(ctx, m) == sdbus::errc::success);
+
+    sd_bus_message_seal(msg(), 100, 0);
+
+    auto& pool = sdbus::intern_pool::global();
+    std::vector<sdbus::interned_string> names2;
+    EXPECT_TRUE(sdbus::read(ctx, names2) == sdbus::errc::success);
+    ASSERT_EQ(names2.size(), 2);
+    EXPECT_EQ(names2[0], names2[1]);
+    EXPECT_EQ(names2[0].c_str(), names2[1].c_str());
+    EXPECT_EQ(names2[0], "org.example.Sensor");
+    EXPECT_EQ(names2[0], sdbus::interned_string("org.example.Sensor"));
+
+    auto size = pool.size();
+    EXPECT_TRUE(sdbus::read(ctx, path) == sdbus::errc::success);
+    EXPECT_EQ(path, "/org/example/sensor0");
+    EXPECT_EQ(pool.size(), size + 1);
+
+    EXPECT_TRUE(sdbus::read(ctx, m2) == sdbus::errc::success);
+    EXPECT_EQ(m2.at(sdbus::interned_string("Value")), 1);
+    EXPECT_EQ(m2.at(sdbus::interned_string("Unit")), 2);
+    EXPECT_TRUE(sdbus::interned_string().empty());
+}
+
+TEST(InternPool, Limit)
+{
+    sdbus::intern_pool pool(64);
+    sdbus::interned_string a, b;
+
+    EXPECT_TRUE(pool.intern("org.example.A", a) == sdbus::errc::success);
+    EXPECT_TRUE(pool.intern(std::string(64, 'x'), b) == sdbus::errc::out_of_space);
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(pool.size(), 1);
+
+    auto bytes = pool.bytes();
+    EXPECT_TRUE(pool.intern("org.example.A", b) == sdbus::errc::success);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(pool.bytes(), bytes);
+
+    EXPECT_THROW(pool.intern(std::string(64, 'y')), std::system_error);
+}
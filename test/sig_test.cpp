@@ -50,3 +50,22 @@ TEST(Signature, As)
     EXPECT_EQ(sig(as<objpath>(s)), "o");
     EXPECT_EQ(sig(as<std::string>(o)), "s");
 }
+
+struct point
+{
+    int32_t x;
+    int32_t y;
+    using struct_t = members<&point::x, &point::y>;
+};
+
+TEST(Signature, StructSig)
+{
+    EXPECT_EQ((traits<std::tuple<int32_t, std::string, std::vector<double>>>::sig), "(isad)");
+    EXPECT_EQ((traits<std::pair<std::vector<int32_t>, bool>>::sig), "(aib)");
+    EXPECT_EQ((traits<std::pair<std::string, int32_t>>::sig), "(si)");
+    EXPECT_EQ((traits<std::vector<std::pair<std::string, int32_t>>>::sig), "a{si}");
+    EXPECT_EQ((traits<std::map<int32_t, std::pair<std::string, int32_t>>>::sig), "a{i(si)}");
+    EXPECT_EQ(traits<point>::sig, "(ii)");
+    EXPECT_EQ((traits<std::vector<std::tuple<uint8_t, point>>>::sig), "a(y(ii))");
+    EXPECT_TRUE(traits<point>::layout_compatible);
+}
@@ -0,0 +1,126 @@
+
+#include <sdbus/wire.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace sdbus;
+
+struct record
+{
+    int32_t id;
+    std::string name;
+    std::vector<double> samples;
+
+    using dict_t = std::tuple<property<"id", &record::id>, property<"name", &record::name>,
+                              property<"samples", &record::samples>>;
+};
+
+struct sample
+{
+    uint64_t time;
+    double min;
+    double max;
+};
+
+template <>
+struct sdbus::traits<sample> : struct_traits<sample, &sample::time, &sample::min, &sample::max>
+{};
+
+static constexpr size_t iterations = 1000;
+
+/*
+ * Average time of `run`, given what `prepare` returns for each iteration.
+ * Preparing and destroying that state is not timed.
+ */
+template <typename P, typename F>
+static double measure(P&& prepare, F&& run)
+{
+    std::chrono::duration<double, std::micro> elapsed{};
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        auto state = prepare();
+        auto start = std::chrono::steady_clock::now();
+        auto ec = run(state);
+        elapsed += std::chrono::steady_clock::now() - start;
+        if (is_error(ec))
+        {
+            std::fprintf(stderr, "benchmark iteration failed\n");
+            std::exit(1);
+        }
+    }
+    return elapsed.count() / iterations;
+}
+
+struct message_deleter
+{
+    void operator()(sd_bus_message* msg) const
+    {
+        sd_bus_message_unref(msg);
+    }
+};
+
+using message_ptr = std::unique_ptr<sd_bus_message, message_deleter>;
+
+template <typename T>
+static void compare(const char* name, sd_bus* bus, const T& v)
+{
+    std::vector<uint8_t> buf(1 << 24);
+
+    auto wire_us = measure([&] { return wire::encoder(buf); },
+                           [&](wire::encoder& e) { return wire::encode(e, v); });
+
+    // Message allocation stays out of the timed part, as the encoder's buffer does.
+    auto sdbus_us = measure(
+        [&] {
+            sd_bus_message* msg = nullptr;
+            if (sd_bus_message_new(bus, &msg, SD_BUS_MESSAGE_METHOD_CALL) < 0)
+            {
+                std::fprintf(stderr, "can't create message\n");
+                std::exit(1);
+            }
+            return message_ptr(msg);
+        },
+        [&](message_ptr& msg) { return write(msg.get(), v); });
+
+    std::printf("%-24s wire %10.2f us  sdbus::write %10.2f us\n", name, wire_us, sdbus_us);
+}
+
+int main()
+{
+    sd_bus* bus;
+    if (sd_bus_default(&bus) < 0)
+    {
+        std::fprintf(stderr, "no bus connection\n");
+        return 1;
+    }
+
+    std::vector<uint32_t> ints(100000);
+    for (size_t i = 0; i < ints.size(); ++i)
+    {
+        ints[i] = i;
+    }
+    compare("au (100000)", bus, ints);
+
+    std::vector<std::string> strings(10000, "org.freedesktop.DBus");
+    compare("as (10000)", bus, strings);
+
+    std::map<std::string, std::variant<int32_t, std::string>> props;
+    for (int i = 0; i < 1000; ++i)
+    {
+        props.emplace(std::to_string(i), i);
+    }
+    compare("a{sv} (1000)", bus, props);
+
+    std::vector<record> records(1000, record{42, "sensor", std::vector<double>(16, 1.5)});
+    compare("aa{sv} (1000 dicts)", bus, records);
+
+    std::vector<sample> samples(50000, sample{1, -1.0, 1.0});
+    compare("a(tdd) (50000)", bus, samples);
+
+    sd_bus_unref(bus);
+    return 0;
+}
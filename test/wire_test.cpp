@@ -0,0 +1,390 @@
+
+#include <sdbus/wire.hpp>
+
+#include <gtest/gtest.h>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace sdbus;
+
+using bytes = std::vector<uint8_t>;
+
+struct dict_s
+{
+    int32_t a;
+    std::string b;
+    std::vector<uint16_t> c;
+
+    using dict_t = std::tuple<property<"a", &dict_s::a>, property<"b", &dict_s::b>,
+                              property<"c", &dict_s::c>>;
+};
+
+enum class state : uint8_t
+{
+    running,
+    degraded,
+};
+
+template <>
+struct sdbus::traits<state> : enum_string_traits<state, "Running", "Degraded">
+{};
+
+struct sample
+{
+    uint64_t time;
+    double min;
+    double max;
+
+    bool operator==(const sample&) const = default;
+};
+
+template <>
+struct sdbus::traits<sample> : struct_traits<sample, &sample::time, &sample::min, &sample::max>
+{};
+
+// Listed out of memory order: the wire order has to win over the layout.
+struct swapped
+{
+    uint64_t time;
+    double min;
+    double max;
+};
+
+template <>
+struct sdbus::traits<swapped> : struct_traits<swapped, &swapped::time, &swapped::max, &swapped::min>
+{};
+
+struct padded
+{
+    int32_t a;
+    double b;
+
+    bool operator==(const padded&) const = default;
+};
+
+template <>
+struct sdbus::traits<padded> : struct_traits<padded, &padded::a, &padded::b>
+{};
+
+template <typename... Ts>
+static bytes encode(const Ts&... vs)
+{
+    std::array<uint8_t, 1024> buf;
+    wire::encoder e(buf);
+    auto ec = errc::success;
+    (void)(... && no_error(ec = wire::encode(e, vs)));
+    EXPECT_TRUE(ec == errc::success);
+    return bytes(e.data().begin(), e.data().end());
+}
+
+template <typename T>
+static T decode(const bytes& b)
+{
+    T v{};
+    wire::decoder d(b);
+    EXPECT_TRUE(wire::decode(d, v) == errc::success);
+    EXPECT_TRUE(d.at_end());
+    return v;
+}
+
+TEST(Wire, Basic)
+{
+    EXPECT_EQ(encode(uint8_t{1}, uint32_t{2}, int16_t{-1}),
+              (bytes{0x01, 0, 0, 0, 0x02, 0, 0, 0, 0xff, 0xff}));
+    EXPECT_EQ(encode(true), (bytes{1, 0, 0, 0}));
+    EXPECT_EQ(encode(uint8_t{7}, 1.0),
+              (bytes{7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xf0, 0x3f}));
+
+    EXPECT_EQ(decode<int16_t>(bytes{0xfe, 0xff}), -2);
+    EXPECT_EQ(decode<uint64_t>(bytes{1, 2, 3, 4, 5, 6, 7, 8}), 0x0807060504030201);
+
+    bool b;
+    bytes invalid_bool{2, 0, 0, 0};
+    wire::decoder d(invalid_bool);
+    EXPECT_TRUE(wire::decode(d, b) == errc::invalid_type);
+}
+
+TEST(Wire, Strings)
+{
+    EXPECT_EQ(encode(std::string("ab")), (bytes{2, 0, 0, 0, 'a', 'b', 0}));
+    EXPECT_EQ(encode(objpath("/")), (bytes{1, 0, 0, 0, '/', 0}));
+    EXPECT_EQ(encode(uint8_t{1}, std::string_view("")), (bytes{1, 0, 0, 0, 0, 0, 0, 0, 0}));
+
+    EXPECT_EQ(decode<std::string>(bytes{3, 0, 0, 0, 'a', 'b', 'c', 0}), "abc");
+
+    std::string s;
+    bytes unterminated{3, 0, 0, 0, 'a', 'b', 'c', 'd'};
+    wire::decoder d(unterminated);
+    EXPECT_TRUE(wire::decode(d, s) == errc::read_error);
+}
+
+TEST(Wire, Arrays)
+{
+    // The padding before the first element is not part of the array length.
+    EXPECT_EQ(encode(std::vector<uint64_t>{1}),
+              (bytes{8, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0}));
+    EXPECT_EQ(encode(std::vector<uint64_t>{}), (bytes{0, 0, 0, 0, 0, 0, 0, 0}));
+    EXPECT_EQ(encode(std::vector<std::string>{"a", "b"}),
+              (bytes{14, 0, 0, 0, 1, 0, 0, 0, 'a', 0, 0, 0, 1, 0, 0, 0, 'b', 0}));
+
+    EXPECT_EQ(encode(std::map<std::string, int32_t>{{"a", 1}}),
+              (bytes{12, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 'a', 0, 0, 0, 1, 0, 0, 0}));
+
+    std::vector<uint16_t> v{1, 2, 3};
+    EXPECT_EQ(decode<std::vector<uint16_t>>(encode(v)), v);
+
+    std::map<std::string, std::vector<std::string>> m{{"a", {"x", "y"}}, {"b", {}}};
+    EXPECT_EQ((decode<std::map<std::string, std::vector<std::string>>>(encode(m))), m);
+
+    std::array<int32_t, 2> a;
+    auto three = encode(std::vector<int32_t>{1, 2, 3});
+    wire::decoder d(three);
+    EXPECT_TRUE(wire::decode(d, a) == errc::out_of_space);
+}
+
+TEST(Wire, Structs)
+{
+    EXPECT_EQ(traits<sample>::sig, "(tdd)");
+    EXPECT_TRUE(traits<sample>::layout_compatible);
+    EXPECT_FALSE(traits<padded>::layout_compatible);
+    EXPECT_FALSE(traits<swapped>::layout_compatible);
+    using repeated = struct_traits<sample, &sample::time, &sample::min, &sample::min>;
+    EXPECT_FALSE(repeated::layout_compatible);
+
+    EXPECT_EQ(encode(uint8_t{1}, padded{-1, 1.0}),
+              (bytes{1, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 0xff, 0xff, 0, 0, 0, 0,
+                     0, 0, 0, 0, 0, 0, 0xf0, 0x3f}));
+
+    // Copied in one piece, but the same bytes as field by field.
+    std::vector<sample> samples{{1, -1.0, 1.0}, {2, 0.5, 2.0}};
+    auto bulk = encode(samples);
+    auto fields = encode(uint32_t{48}, samples[0], samples[1]);
+    EXPECT_EQ(bulk, fields);
+    EXPECT_EQ(decode<std::vector<sample>>(bulk), samples);
+
+    std::vector<swapped> sw{{1, -1.0, 1.0}};
+    EXPECT_EQ(encode(sw), encode(uint32_t{24}, uint64_t{1}, 1.0, -1.0));
+
+    std::vector<padded> p{{1, 2.0}, {3, 4.0}};
+    EXPECT_EQ(encode(p).size(), 40);
+    EXPECT_EQ(decode<std::vector<padded>>(encode(p)), p);
+
+    std::tuple<uint8_t, std::string> t{1, "a"};
+    EXPECT_EQ(encode(t), (bytes{1, 0, 0, 0, 1, 0, 0, 0, 'a', 0}));
+    EXPECT_EQ(decode<decltype(t)>(encode(t)), t);
+
+    std::array<sample, 1> one;
+    wire::decoder d(bulk);
+    EXPECT_TRUE(wire::decode(d, one) == errc::out_of_space);
+}
+
+TEST(Wire, Variants)
+{
+    using var = std::variant<int32_t, std::string>;
+
+    EXPECT_EQ(encode(var(5)), (bytes{1, 'i', 0, 0, 5, 0, 0, 0}));
+    EXPECT_EQ(encode(var("x")), (bytes{1, 's', 0, 0, 1, 0, 0, 0, 'x', 0}));
+
+    EXPECT_EQ(decode<var>(encode(var("abc"))), var("abc"));
+
+    var v;
+    auto other = encode(std::variant<double>(1.0));
+    wire::decoder d(other);
+    EXPECT_TRUE(wire::decode(d, v) == errc::bad_variant);
+}
+
+TEST(Wire, Dict)
+{
+    dict_s s{1, "x", {2}};
+
+    // a{sv}: "a" -> <i 1>, "b" -> <s "x">, "c" -> <aq [2]>
+    EXPECT_EQ(encode(s), (bytes{58,  0, 0, 0,   0,   0,   0, 0,   // length, padding
+                                1,   0, 0, 0,   'a', 0,   1, 'i', // "a", <i
+                                0,   0, 0, 0,   1,   0,   0, 0,   // 1>
+                                1,   0, 0, 0,   'b', 0,   1, 's', // "b", <s
+                                0,   0, 0, 0,   1,   0,   0, 0,   // "x"
+                                'x', 0, 0, 0,   0,   0,   0, 0,   // >, padding
+                                1,   0, 0, 0,   'c', 0,   2, 'a', // "c", <aq
+                                'q', 0, 0, 0,   2,   0,   0, 0,   // [2]>
+                                2,   0}));
+
+    auto r = decode<dict_s>(encode(s));
+    EXPECT_EQ(r.a, 1);
+    EXPECT_EQ(r.b, "x");
+    EXPECT_EQ(r.c, std::vector<uint16_t>{2});
+
+    // Unknown properties are skipped, mistyped ones rejected.
+    using other_dict = std::map<std::string, std::variant<int32_t, std::string>>;
+    auto b = encode(other_dict{{"a", 3}, {"z", "skip"}});
+    EXPECT_EQ(decode<dict_s>(b).a, 3);
+
+    dict_s t;
+    auto mistyped = encode(other_dict{{"a", "x"}});
+    wire::decoder d(mistyped);
+    EXPECT_TRUE(wire::decode(d, t) == errc::invalid_type);
+}
+
+TEST(Wire, Enums)
+{
+    EXPECT_EQ(encode(state::degraded),
+              (bytes{8, 0, 0, 0, 'D', 'e', 'g', 'r', 'a', 'd', 'e', 'd', 0}));
+    EXPECT_EQ(decode<state>(encode(state::running)), state::running);
+
+    state s;
+    auto unknown = encode(std::string("Stopped"));
+    wire::decoder d(unknown);
+    EXPECT_TRUE(wire::decode(d, s) == errc::invalid_enum_string);
+}
+
+TEST(Wire, Skip)
+{
+    auto b = encode(std::map<std::string, std::variant<int32_t, std::vector<std::string>>>{
+                        {"a", 1}, {"b", std::vector<std::string>{"x"}}},
+                    uint8_t{9});
+
+    std::string_view sig = "a{sv}y";
+    wire::decoder d(b);
+    EXPECT_TRUE(wire::skip(d, sig) == errc::success);
+    EXPECT_EQ(sig, "y");
+
+    uint8_t y = 0;
+    EXPECT_TRUE(wire::decode(d, y) == errc::success);
+    EXPECT_EQ(y, 9);
+    EXPECT_TRUE(d.at_end());
+}
+
+TEST(Wire, OutOfSpace)
+{
+    std::array<uint8_t, 6> buf;
+    wire::encoder e(buf);
+    EXPECT_TRUE(wire::encode(e, std::string("abc")) == errc::out_of_space);
+
+    bytes truncated{4, 0, 0, 0, 1, 0};
+    std::vector<uint32_t> v;
+    wire::decoder d(truncated);
+    EXPECT_TRUE(wire::decode(d, v) == errc::read_error);
+}
+
+/*
+ * The far end of an sd-bus connection over a socketpair. It answers the
+ * client's authentication and hands back the raw bytes the client sends,
+ * so that message bodies built by sd-bus can be compared with the codec.
+ */
+struct raw_peer
+{
+    raw_peer()
+    {
+        int fds[2];
+        EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds), 0);
+        _fd = fds[1];
+        EXPECT_GE(sd_bus_new(&_bus), 0);
+        EXPECT_GE(sd_bus_set_fd(_bus, fds[0], fds[0]), 0);
+        EXPECT_GE(sd_bus_negotiate_fds(_bus, 0), 0);
+        EXPECT_GE(sd_bus_start(_bus), 0);
+
+        // Newer clients send AUTH EXTERNAL without an initial response.
+        EXPECT_TRUE(receive([&] { return _in.find("\r\n") != std::string::npos; }));
+        std::string reply = _in.find("AUTH EXTERNAL\r\n") != std::string::npos ? "DATA\r\n" : "";
+        reply += "OK 0123456789abcdef0123456789abcdef\r\n";
+        EXPECT_EQ(::write(_fd, reply.data(), reply.size()), ssize_t(reply.size()));
+    }
+
+    ~raw_peer()
+    {
+        sd_bus_flush_close_unref(_bus);
+        ::close(_fd);
+    }
+
+    // Sends a signal filled in by `fill` and returns its body as received.
+    template <typename F>
+    bytes body(F&& fill)
+    {
+        sd_bus_message* m;
+        EXPECT_GE(sd_bus_message_new_signal(_bus, &m, "/org/example", "org.example.Wire", "Body"),
+                  0);
+        fill(m);
+        EXPECT_GE(sd_bus_send(_bus, m, nullptr), 0);
+        sd_bus_message_unref(m);
+        EXPECT_GE(sd_bus_flush(_bus), 0);
+
+        // The message follows the client's BEGIN line.
+        size_t start;
+        auto have_header = [&] {
+            start = _in.find("BEGIN\r\n");
+            return start != std::string::npos && _in.size() >= (start += 7) + 16;
+        };
+        if (!receive(have_header))
+        {
+            return {};
+        }
+
+        uint32_t body_size, fields_size;
+        std::memcpy(&body_size, _in.data() + start + 4, sizeof(body_size));
+        std::memcpy(&fields_size, _in.data() + start + 12, sizeof(fields_size));
+        auto body_start = start + ((16 + fields_size + 7) & ~size_t{7});
+        if (!receive([&] { return _in.size() >= body_start + body_size; }))
+        {
+            return {};
+        }
+        return bytes(_in.begin() + body_start, _in.begin() + body_start + body_size);
+    }
+
+  private:
+    template <typename P>
+    bool receive(P&& done)
+    {
+        while (!done())
+        {
+            pollfd p{_fd, POLLIN, 0};
+            char buf[4096];
+            if (::poll(&p, 1, 5000) != 1)
+            {
+                ADD_FAILURE() << "timed out waiting for sd-bus";
+                return false;
+            }
+            auto n = ::read(_fd, buf, sizeof(buf));
+            if (n <= 0)
+            {
+                ADD_FAILURE() << "sd-bus closed the connection";
+                return false;
+            }
+            _in.append(buf, n);
+        }
+        return true;
+    }
+
+    sd_bus* _bus = nullptr;
+    int _fd = -1;
+    std::string _in;
+};
+
+TEST(Wire, MatchesSdBus)
+{
+    if constexpr (std::endian::native != std::endian::little)
+    {
+        GTEST_SKIP() << "sd-bus writes messages in native byte order";
+    }
+
+    std::vector<uint32_t> ints{1, 2, 3};
+    std::map<std::string, std::variant<int32_t, std::string>> props{{"a", 1}, {"b", "two"}};
+    dict_s dict{-1, "text", {1, 2}};
+    std::vector<sample> samples{{1, -1.0, 1.0}, {2, -2.0, 2.0}};
+    std::tuple<uint8_t, std::string, double> t{7, "seven", 7.5};
+    std::pair<int16_t, bool> p{-2, true};
+
+    raw_peer peer;
+    auto body = peer.body([&](sd_bus_message* m) {
+        EXPECT_TRUE(write_all(m, uint8_t{1}, ints, props, dict, samples, t, p, state::degraded) ==
+                    errc::success);
+    });
+    EXPECT_EQ(body, encode(uint8_t{1}, ints, props, dict, samples, t, p, state::degraded));
+}